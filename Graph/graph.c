@@ -1,16 +1,126 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
-#define MAX_NODES 30
+#define EPSILON 1e-9
+#define BETWEENNESS_SCALE 1048576.0//Betweenness sums are kept in fixed point with this scale
+#define SNAPSHOT_MAGIC "GNSNAP\0\0"
+#define SNAPSHOT_VERSION 2
+#define BUCKET_QUEUE_LIMIT 65536//Integer weights up to this value use the bucket queue
+#define COMPACTION_RATIO 8//Adjacency is compacted when 1/COMPACTION_RATIO of the slots belong to removed edges
+
+_Static_assert(sizeof(int) == sizeof(int32_t), "offsets are stored as int32 in snapshots");
+
+/*
+@brief struct for graph, adjacency is kept in compressed sparse row (CSR) form.
+        Neighbors of node i are targets[offsets[i]] ... targets[offsets[i+1]-1]. A removed edge is only cleared in
+        alive, its slots stay in targets until the adjacency is compacted
+*/
+struct Graph {
+    int nodeCount;
+    int slotCount;//Length of targets, every undirected edge has two slots
+    int edgeCount;
+    int* offsets;
+    int32_t* targets;
+    int32_t* edgeIds;//edgeIds[k] is the id of the edge in slot k, both slots of an edge have the same id
+    int32_t* edgeEnds;//Edge e is (edgeEnds[2*e], edgeEnds[2*e+1]) with edgeEnds[2*e] < edgeEnds[2*e+1]
+    uint64_t* alive;//Bit e is 1 while edge e is in the graph
+    int deadSlots;//Slots in targets that belong to removed edges
+    double* weights;//Weight of the edge in every slot of targets, NULL if the graph is unweighted
+    double* edgeWeights;//Weight of every edge id, NULL if the graph is unweighted
+    int integerWeights;//1 if all weights are integers not larger than BUCKET_QUEUE_LIMIT
+    int maxWeight;//Largest weight if integerWeights is 1
+    char** names;
+    char* nameData;//Null terminated names of all nodes, names[i] points into it
+    void* mapping;//Snapshot mapping that the arrays point into, NULL if the arrays are allocated
+    size_t mappingSize;
+};
+
+/*
+@brief struct for the state of the Girvan-Newman loop that is saved in a checkpoint
+*/
+struct Checkpoint {
+    int iteration;//Next iteration to run
+    int repeatedCommunityNumberCounter;
+};
+
+/*
+@brief struct for the header of a binary graph snapshot. It is followed by the sections offsets (nodeCount+1),
+        targets (slotCount), edgeIds (slotCount), edgeEnds (2*edgeCount) as int32 arrays, the name offsets as uint64
+        array and the null terminated names. Weighted graphs also have the weights (slotCount) and edgeWeights
+        (edgeCount) sections as double arrays. Every section starts at a multiple of 8 bytes
+*/
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t weighted;//1 if the weights sections are present
+    uint64_t fileSize;
+    int64_t nodeCount;
+    int64_t slotCount;
+    int64_t edgeCount;
+    int64_t iteration;
+    int64_t repeatedCommunityNumberCounter;
+    uint64_t offsetsPosition;
+    uint64_t targetsPosition;
+    uint64_t edgeIdsPosition;
+    uint64_t edgeEndsPosition;
+    uint64_t nameOffsetsPosition;
+    uint64_t nameDataPosition;
+    uint64_t nameDataLength;
+    uint64_t weightsPosition;
+    uint64_t edgeWeightsPosition;
+};
+
+/*
+@brief struct for the edges read from a file before the adjacency is built
+*/
+struct EdgeList {
+    int32_t* edges;//Edge i is (edges[2*i], edges[2*i+1])
+    double* weights;
+    int count;
+    int capacity;
+    int weighted;//1 if a weight was read
+};
+
+/*
+@brief struct for a neighbor and the weight of the edge to it, used to sort rows of weighted graphs
+*/
+struct AdjacencyEntry {
+    int32_t target;
+    double weight;
+};
+
+/*
+@brief struct for the hash table that gives dense ids to node names while a graph is read
+*/
+struct NameTable {
+    int* slots;//Open addressing slots with linear probing, a slot keeps a node id or -1
+    int capacity;//Number of slots, a power of 2
+    int count;//Number of names
+    int countCapacity;
+    size_t* nameOffsets;//Name of id i starts at data + nameOffsets[i]
+    int* nameLengths;
+    char* data;
+    size_t dataLength;
+    size_t dataCapacity;
+};
 
 /*
-@brief struct for graph
+@brief struct for an edge and its betweenness, used to sort edges when the top edges are removed
 */
-struct Node {
-    char data;
-    struct Node* neighbors[MAX_NODES];
-    int neighborCount;
+struct RankedEdge {
+    double value;
+    int edge;
 };
 
 /*
@@ -27,10 +137,126 @@ struct Queue {
 */
 struct Community{
     int communityNumber;
-    int* visited;
+    int* visited;//Community of every node
+    int* communitySize;//Number of nodes in every community
     int isEnd;
 };
 
+/*
+@brief struct for the settings of the betweenness calculation
+*/
+struct BetweennessOptions {
+    int threadCount;
+    int sampleCount;//Number of sampled sources, 0 to use epsilon or all sources
+    double epsilon;//Target error relative to n(n-1)/2, 0 if the sample size is not derived from it
+    double delta;//Probability that the error is larger than the bound
+    uint64_t randomState;
+    int topCount;//Number of edges removed in every iteration, 0 to remove only the edges with the highest betweenness
+    int quiet;//1 if paths, betweenness values and the graph are not printed
+};
+
+/*
+@brief struct for the measurements of one Girvan-Newman iteration, written by --stats
+*/
+struct IterationStats {
+    int iteration;
+    double betweennessTime;//Seconds spent in BFS or Dijkstra and merging the accumulators
+    double removalTime;//Seconds spent finding and removing the edges with the highest betweenness
+    double componentTime;//Seconds spent finding the communities after the removal
+    int searchCount;//Number of BFS or Dijkstra runs, one per processed source
+    long long visitedEdges;//Number of adjacency slots scanned by the searches
+    int removedEdges;
+    int communityNumber;
+    double modularity;
+};
+
+/*
+@brief struct for a level of the Louvain method. Nodes of a level are communities of the previous level, edges
+        are weighted and the edges inside a node are kept as a self loop
+*/
+struct LouvainGraph {
+    int nodeCount;
+    int* offsets;
+    int* targets;
+    double* weights;
+    double* selfLoops;
+    double* degrees;//Total weight of the edges of every node, self loops are counted twice
+    double totalWeight;//Sum of degrees, 2m
+};
+
+/*
+@brief struct for edge betweenness values kept between iterations. Removing an edge only changes the shortest paths
+        inside its own connected component, so values of the other components are reused in the next iteration
+*/
+struct BetweennessCache {
+    int nodeCount;
+    double* values;//values[e] is the betweenness of edge e
+    int* dirty;//dirty[c] is 1 if community c must be recalculated
+    int* touched;//Endpoints of the edges removed in the last iteration
+    int touchedCount;
+    int allDirty;//1 if every community must be recalculated
+    long long** accumulators;//accumulators[t] holds the private sums of thread t, only edges of dirty communities are nonzero
+    int accumulatorCount;//Number of accumulators, they are allocated by the first calculation
+};
+
+/*
+@brief struct for the range of sources owned by a betweenness worker, other workers steal from it when they are idle
+*/
+struct WorkRange {
+    atomic_int next;
+    int end;
+};
+
+/*
+@brief struct for a thread that calculates the dependencies of a set of sources
+*/
+struct BetweennessWorker {
+    struct Graph* graph;
+    int* sources;//Sources of dirty communities, shared by all workers
+    struct WorkRange* ranges;//Ranges of all workers
+    int threadCount;
+    int id;
+    int printPaths;
+    long long visitedEdges;//Number of adjacency slots scanned by the searches of this worker
+    long long* accumulator;//Private betweenness sums, indexed by edge id. It belongs to the cache and is zero between iterations
+    int* distance;
+    int* parent;
+    int* order;//Nodes in the order they are visited by BFS
+    double* sigma;//Number of shortest paths from source to each node
+    double* delta;//Dependency of source on each node
+    struct Queue* queue;
+    double* weightedDistance;//Distances of Dijkstra, NULL if the graph is unweighted
+    struct BucketQueue* buckets;//Priority queue of Dijkstra for integer weights
+    struct DaryHeap* heap;//Priority queue of Dijkstra for real weights
+};
+
+/*
+@brief struct for a monotone bucket queue (Dial's algorithm) used by Dijkstra when the weights are small integers.
+        Distances in the queue are always between the last extracted distance d and d + maxWeight, so maxWeight+1
+        circular buckets are enough. Every bucket is a doubly linked list of nodes, a key is decreased by moving the
+        node to another bucket in O(1)
+*/
+struct BucketQueue {
+    int bucketCount;
+    int* heads;//First node of every bucket, -1 if bucket is empty
+    int* next;
+    int* previous;
+    int* bucketOf;//Bucket of every node, -1 if node is not in queue
+    long long current;//Distance of the bucket that is scanned
+    int size;
+};
+
+/*
+@brief struct for a 4-ary min heap with decrease-key, used by Dijkstra when the weights are real numbers.
+        Four children per node make the heap shallower and keep the children of a node in one cache line
+*/
+struct DaryHeap {
+    int* nodes;
+    int* position;//Index of every node in nodes, -1 if node is not in heap
+    double* keys;//Distances of the nodes, shared with the worker
+    int size;
+};
+
 /*
 @brief creates a queue
 @param capacity capacity of queue
@@ -95,340 +321,2559 @@ int dequeue(struct Queue* queue) {
 }
 
 /*
-@brief reads graph from file
-@param graph graph to read
-@param nodeCount node count of graph
-@param filename file name to read
+@brief frees a queue
+@param queue queue to free
 */
-void readGraph(struct Node* graph[], int* nodeCount, const char* filename) {
-    FILE* file = fopen(filename, "r");
-    if (!file) {
-        perror("File error!");
-        exit(EXIT_FAILURE);
+void freeQueue(struct Queue* queue) {
+    free(queue->array);
+    free(queue);
+}
+
+/*
+@brief creates an empty bucket queue
+@param nodeCount number of nodes that can be in queue
+@param maxWeight largest edge weight
+@return created queue
+*/
+struct BucketQueue* createBucketQueue(int nodeCount, int maxWeight) {
+    struct BucketQueue* queue = (struct BucketQueue*)malloc(sizeof(struct BucketQueue));
+    int i;
+    queue->bucketCount = maxWeight + 1;
+    queue->heads = (int*)malloc(sizeof(int) * queue->bucketCount);
+    queue->next = (int*)malloc(sizeof(int) * (nodeCount + 1));
+    queue->previous = (int*)malloc(sizeof(int) * (nodeCount + 1));
+    queue->bucketOf = (int*)malloc(sizeof(int) * (nodeCount + 1));
+    for (i = 0; i < queue->bucketCount; i++) {
+        queue->heads[i] = -1;
     }
+    for (i = 0; i < nodeCount; i++) {
+        queue->bucketOf[i] = -1;
+    }
+    queue->current = 0;
+    queue->size = 0;
+    return queue;
+}
 
-    char line[100];  // Max size of line
+/*
+@brief frees a bucket queue
+@param queue queue to free
+*/
+void freeBucketQueue(struct BucketQueue* queue) {
+    free(queue->heads);
+    free(queue->next);
+    free(queue->previous);
+    free(queue->bucketOf);
+    free(queue);
+}
 
-    while (fgets(line, sizeof(line), file)) {
-        char nodeData;
-        sscanf(line, "%c:", &nodeData);
+/*
+@brief adds a node to a bucket queue, if the node is already in queue it is moved to its new distance
+@param queue queue to add node
+@param node node to add
+@param distance distance of node, it must not be smaller than the last extracted distance
+*/
+void bucketQueuePush(struct BucketQueue* queue, int node, long long distance) {
+    int bucket = (int)(distance % queue->bucketCount);
+    if (queue->bucketOf[node] != -1) {
+        //Unlink node from its old bucket
+        if (queue->previous[node] != -1) {
+            queue->next[queue->previous[node]] = queue->next[node];
+        } else {
+            queue->heads[queue->bucketOf[node]] = queue->next[node];
+        }
+        if (queue->next[node] != -1) {
+            queue->previous[queue->next[node]] = queue->previous[node];
+        }
+        queue->size--;
+    }
+    queue->previous[node] = -1;
+    queue->next[node] = queue->heads[bucket];
+    if (queue->heads[bucket] != -1) {
+        queue->previous[queue->heads[bucket]] = node;
+    }
+    queue->heads[bucket] = node;
+    queue->bucketOf[node] = bucket;
+    queue->size++;
+}
 
-        //Create node
-        struct Node* newNode = (struct Node*)malloc(sizeof(struct Node));
-        newNode->data = nodeData;
-        newNode->neighborCount = 0;
+/*
+@brief removes a node with the smallest distance from a bucket queue
+@param queue queue to remove node, it must not be empty
+@return removed node
+*/
+int bucketQueuePop(struct BucketQueue* queue) {
+    int bucket = (int)(queue->current % queue->bucketCount);
+    while (queue->heads[bucket] == -1) {
+        queue->current++;
+        bucket = (int)(queue->current % queue->bucketCount);
+    }
+    int node = queue->heads[bucket];
+    queue->heads[bucket] = queue->next[node];
+    if (queue->next[node] != -1) {
+        queue->previous[queue->next[node]] = -1;
+    }
+    queue->bucketOf[node] = -1;
+    queue->size--;
+    return node;
+}
 
-        //Read neighbors
-        char* neighborStr = strchr(line, ':') + 1;
-        char* token = strtok(neighborStr, ",");
-        while (token != NULL) {
-            struct Node* neighbor = (struct Node*)malloc(sizeof(struct Node));
-            neighbor->data = token[0];
-            neighbor->neighborCount = 0;
+/*
+@brief creates an empty 4-ary heap
+@param nodeCount number of nodes that can be in heap
+@param keys distances of nodes
+@return created heap
+*/
+struct DaryHeap* createDaryHeap(int nodeCount, double* keys) {
+    struct DaryHeap* heap = (struct DaryHeap*)malloc(sizeof(struct DaryHeap));
+    int i;
+    heap->nodes = (int*)malloc(sizeof(int) * (nodeCount + 1));
+    heap->position = (int*)malloc(sizeof(int) * (nodeCount + 1));
+    for (i = 0; i < nodeCount; i++) {
+        heap->position[i] = -1;
+    }
+    heap->keys = keys;
+    heap->size = 0;
+    return heap;
+}
 
-            //Add neighbor to node
-            newNode->neighbors[newNode->neighborCount++] = neighbor;
+/*
+@brief frees a 4-ary heap
+@param heap heap to free
+*/
+void freeDaryHeap(struct DaryHeap* heap) {
+    free(heap->nodes);
+    free(heap->position);
+    free(heap);
+}
 
-            token = strtok(NULL, ",");
+/*
+@brief moves the node at index up until its parent is not larger
+@param heap heap to fix
+@param index index of node in heap
+*/
+void daryHeapSiftUp(struct DaryHeap* heap, int index) {
+    int node = heap->nodes[index];
+    double key = heap->keys[node];
+    while (index > 0) {
+        int parent = (index - 1) / 4;
+        if (heap->keys[heap->nodes[parent]] <= key) {
+            break;
         }
-
-        //Add node to graph
-        graph[(*nodeCount)++] = newNode;
+        heap->nodes[index] = heap->nodes[parent];
+        heap->position[heap->nodes[index]] = index;
+        index = parent;
     }
+    heap->nodes[index] = node;
+    heap->position[node] = index;
+}
 
-    fclose(file);
+/*
+@brief adds a node to a 4-ary heap, if the node is already in heap its key was decreased and it is moved up
+@param heap heap to add node
+@param node node to add, its key must be set in heap->keys
+*/
+void daryHeapPush(struct DaryHeap* heap, int node) {
+    if (heap->position[node] == -1) {
+        heap->nodes[heap->size] = node;
+        heap->position[node] = heap->size++;
+    }
+    daryHeapSiftUp(heap, heap->position[node]);
 }
 
 /*
-@brief prints graph
-@param graph graph to print
-@param nodeCount node count of graph
+@brief removes the node with the smallest key from a 4-ary heap
+@param heap heap to remove node, it must not be empty
+@return removed node
 */
-void printGraph(struct Node* graph[], int nodeCount) {
-    printf("\nGraph:\n");
-    int i,j;
-    for (i = 0; i < nodeCount; ++i) {
-        printf("%c:", graph[i]->data);
-        for (j = 0; j < graph[i]->neighborCount; ++j) {
-            if(graph[i]->neighbors[j]!=NULL){
-                printf("%c,", graph[i]->neighbors[j]->data);
+int daryHeapPop(struct DaryHeap* heap) {
+    int top = heap->nodes[0];
+    int node = heap->nodes[--heap->size];
+    double key = heap->keys[node];
+    int index = 0;
+    int child, smallest, i;
+    heap->position[top] = -1;
+    if (heap->size > 0) {
+        //Move the last node down from the root
+        while (1) {
+            child = 4 * index + 1;
+            if (child >= heap->size) {
+                break;
+            }
+            smallest = child;
+            for (i = child + 1; i < child + 4 && i < heap->size; i++) {
+                if (heap->keys[heap->nodes[i]] < heap->keys[heap->nodes[smallest]]) {
+                    smallest = i;
+                }
+            }
+            if (heap->keys[heap->nodes[smallest]] >= key) {
+                break;
             }
+            heap->nodes[index] = heap->nodes[smallest];
+            heap->position[heap->nodes[index]] = index;
+            index = smallest;
         }
-        printf("\n");
+        heap->nodes[index] = node;
+        heap->position[node] = index;
     }
-    printf("\n");
+    return top;
 }
 
 /*
-@brief finds shortest paths and calculates edge betweenness then removes the edges that have highest edge betweenness
-@param graph graph to find shortest path and calculate edge betweenness
-@param nodeCount node count of graph
+@brief calculates the FNV-1a hash of a node name
+@param name first character of name, it does not have to be null terminated
+@param length length of name
+@return hash value
 */
-void findShortestPathAndCalculateEdgeBetweenness(struct Node* graph[],int nodeCount) {
+uint64_t hashName(const char* name, size_t length) {
+    uint64_t hash = 14695981039346656037ULL;
+    size_t i;
+    for (i = 0; i < length; i++) {
+        hash ^= (unsigned char)name[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
 
-    int edgeBetweenness[nodeCount][nodeCount];
-    int visited[nodeCount];
-    int parent[nodeCount];
-    int source,destination,isFound,current;
-    int i,j,k;
-    for(i=0;i<nodeCount;i++){
-        for(j=0;j<nodeCount;j++){
-            edgeBetweenness[i][j]=0;
-        }
+/*
+@brief creates an empty name table
+@param table table to initialize
+*/
+void initNameTable(struct NameTable* table) {
+    int i;
+    table->capacity = 1024;
+    table->slots = (int*)malloc(sizeof(int) * table->capacity);
+    for (i = 0; i < table->capacity; i++) {
+        table->slots[i] = -1;
     }
-    struct Queue* queue = createQueue(nodeCount);
-    //For all nodes find shortest path
-    for(i = 0; i < nodeCount; i++){
-        for(j = 0; j < nodeCount; j++){
-            //Find shortest path between i and j
-            if(i != j){
-                //BFS start from node i, until find node j
-                enqueue(queue, i);
-                for(k=0;k<nodeCount;k++){
-                    visited[k]=0;
-                }
-                for(k=0;k<nodeCount;k++){
-                    parent[k]=-1;
-                }
-                source = i;
-                destination = j;
-                visited[source]=1;
-                isFound = 0;
-                while(!isEmpty(queue) && isFound == 0){
-                    current=dequeue(queue);
-                    for(k=0;k<graph[current]->neighborCount;k++){
-                        if(graph[current]->neighbors[k] != NULL){
-                            if(visited[graph[current]->neighbors[k]->data-'A']==0){
-                                visited[graph[current]->neighbors[k]->data-'A']=1;
-                                parent[graph[current]->neighbors[k]->data-'A']=current;
-                                enqueue(queue,graph[current]->neighbors[k]->data-'A');
-                            }
-                        }
-                    }
-                    if (current == j){
-                        //If destination node found, stop the bfs and clear the queue
-                        isFound = 1;
-                        while(!isEmpty(queue)){
-                            dequeue(queue);
-                        }
-                    }   
-                }
-                if(isFound == 1){
-                    //If shortest path found, increase edge betweenness of the edges traversed
-                    //Print path
-                    source = i;
-                    destination = j;
-                    printf("Path %c -> %c\n",graph[i]->data,graph[j]->data);
-                    while(parent[destination] != source){
-                        printf("%c - ",graph[destination]->data);
-                        destination = parent[destination];
-                        edgeBetweenness[parent[destination]][destination]+=1;
-                        edgeBetweenness[destination][parent[destination]]+=1;
-                    }
-                    printf("%c - %c\n",graph[destination]->data,graph[source]->data);
-                    edgeBetweenness[source][destination]+=1;
-                    edgeBetweenness[destination][source]+=1;
-                }
-            }
+    table->count = 0;
+    table->countCapacity = 1024;
+    table->nameOffsets = (size_t*)malloc(sizeof(size_t) * table->countCapacity);
+    table->nameLengths = (int*)malloc(sizeof(int) * table->countCapacity);
+    table->dataLength = 0;
+    table->dataCapacity = 16384;
+    table->data = (char*)malloc(table->dataCapacity);
+}
+
+/*
+@brief doubles the number of slots of a name table and places the names again
+@param table table to grow
+*/
+void growNameTable(struct NameTable* table) {
+    int i, slot;
+    free(table->slots);
+    table->capacity *= 2;
+    table->slots = (int*)malloc(sizeof(int) * table->capacity);
+    for (i = 0; i < table->capacity; i++) {
+        table->slots[i] = -1;
+    }
+    for (i = 0; i < table->count; i++) {
+        slot = (int)(hashName(table->data + table->nameOffsets[i], table->nameLengths[i]) & (table->capacity - 1));
+        while (table->slots[slot] != -1) {
+            slot = (slot + 1) & (table->capacity - 1);
         }
+        table->slots[slot] = i;
     }
+}
 
-    //Print edge betweenness
-    for(i=0;i<nodeCount;i++){
-        for(j=0;j<i;j++){
-            if(edgeBetweenness[i][j] != 0){
-                printf("\nEdge (%c , %c) : %d times",graph[i]->data,graph[j]->data,edgeBetweenness[i][j]/2);
-            }
+/*
+@brief finds the id of a node name, the name is added to the table with the next id if it is not found.
+        Names are copied to the table only once, when they are seen for the first time
+@param table table to search
+@param name first character of name, it does not have to be null terminated
+@param length length of name
+@return id of node
+*/
+int internName(struct NameTable* table, const char* name, size_t length) {
+    int slot = (int)(hashName(name, length) & (table->capacity - 1));
+    int id;
+    while (table->slots[slot] != -1) {
+        id = table->slots[slot];
+        if ((size_t)table->nameLengths[id] == length && memcmp(table->data + table->nameOffsets[id], name, length) == 0) {
+            return id;
         }
+        slot = (slot + 1) & (table->capacity - 1);
     }
 
-    //Find the edges with the highest betweenness, there can be multiple edges that with the highest betweenness
-    int max = 0;
-    int maxEdgeBetweenness[nodeCount][nodeCount];
-    //Find max value
-    //Set maxEdgeBetweenness 0 simultaneously
-    for(i=0;i<nodeCount;i++){
-        for(j=0;j<nodeCount;j++){
-            maxEdgeBetweenness[i][j]=0;
-            if(edgeBetweenness[i][j] > max){
-                max = edgeBetweenness[i][j];
-            }
-        }
+    //Name is not found, add it
+    if (table->count == table->countCapacity) {
+        table->countCapacity *= 2;
+        table->nameOffsets = (size_t*)realloc(table->nameOffsets, sizeof(size_t) * table->countCapacity);
+        table->nameLengths = (int*)realloc(table->nameLengths, sizeof(int) * table->countCapacity);
     }
-    
-    //Find edges with the highest betweenness
-    for(i=0;i<nodeCount;i++){
-        for(j=0;j<nodeCount;j++){
-            if(edgeBetweenness[i][j] == max){
-                maxEdgeBetweenness[i][j] = 1;
-            }
-        }
+    while (table->dataLength + length + 1 > table->dataCapacity) {
+        table->dataCapacity *= 2;
+        table->data = (char*)realloc(table->data, table->dataCapacity);
     }
-    
-    //Remove edges with the highest betweenness and print them
-    printf("\n");
-    for(i=0;i<nodeCount;i++){
-        for(j=0;j<i;j++){
-            if(maxEdgeBetweenness[i][j] == 1){
-                printf("\nRemoving edge %c --- %c",graph[i]->data,graph[j]->data);
-                for(k=0;k<graph[i]->neighborCount;k++){
-                    if(graph[i]->neighbors[k] != NULL){
-                        if(graph[i]->neighbors[k]->data==graph[j]->data){
-                            graph[i]->neighbors[k]=NULL;
-                        }
-                    }
-
-                }
-                for(k=0;k<graph[j]->neighborCount;k++){
-                    if(graph[j]->neighbors[k] != NULL){
-                        if(graph[j]->neighbors[k]->data==graph[i]->data){
-                            graph[j]->neighbors[k]=NULL;
-                        }
-                    }
-                }
-            }
-        }
+    id = table->count++;
+    memcpy(table->data + table->dataLength, name, length);
+    table->data[table->dataLength + length] = '\0';
+    table->nameOffsets[id] = table->dataLength;
+    table->nameLengths[id] = (int)length;
+    table->dataLength += length + 1;
+    table->slots[slot] = id;
+    if (table->count * 2 > table->capacity) {
+        growNameTable(table);
     }
+    return id;
+}
 
-    printf("\n");
-    printGraph(graph,nodeCount);
+/*
+@brief checks if a character separates node names
+@param c character to check
+@return 1 if c is a space, tab or carriage return, 0 otherwise
+*/
+int isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
 }
 
 /*
-@brief calculates community number, finds which node belongs to which community and 
-        checks if there is a community that has less than or equal to t nodes
-@param graph graph to calculate community number
-@param nodeCount node count of graph
-@param t t value
-@return struct Community that has the information about community number, community nodes and
-        if there is a community that has less than or equal to t nodes
+@brief compares two node ids, used by qsort
 */
-struct Community* calculateCommunityNumber(struct Node* graph[],int nodeCount, int t){
+int compareNodeId(const void* a, const void* b) {
+    int32_t x = *(const int32_t*)a;
+    int32_t y = *(const int32_t*)b;
+    return (x > y) - (x < y);
+}
 
-    int communityNumber = 0;
-    int *visited = (int*)malloc(sizeof(int)*nodeCount);
-    int i,j;
-    int current;
-    for(i=0;i<nodeCount;i++){
-        visited[i]=-1;
-    }
-    //BFS for all nodes except not visited
-    struct Queue* queue = createQueue(nodeCount);
-    for(i = 0; i< nodeCount; i++){
-        if(visited[i] == -1){
-            enqueue(queue, i);
-            //Mark BFS's first node and all other nodes accessible from the node with the community number
-            visited[i] = communityNumber;
-            while(!isEmpty(queue)){
-                current=dequeue(queue);
-                for(j=0;j<graph[current]->neighborCount;j++){
-                    if(graph[current]->neighbors[j] != NULL){
-                        if(visited[graph[current]->neighbors[j]->data-'A'] == -1){
-                            visited[graph[current]->neighbors[j]->data -'A']= communityNumber;
-                            enqueue(queue,graph[current]->neighbors[j]->data-'A');
-                        }
-                    }
-                }
-                
-            }
-            communityNumber++;
-        }
+/*
+@brief checks if the weights of graph are small integers, then Dijkstra can use a bucket queue
+@param graph graph to check, weights must be set
+*/
+void setWeightType(struct Graph* graph) {
+    int i;
+    graph->integerWeights = 0;
+    graph->maxWeight = 0;
+    if (graph->weights == NULL) {
+        return;
     }
-    
-    struct Community* com = (struct Community*)malloc(sizeof(struct Community));
-    //The number of communities is equal to the number of bfs required to visit all nodes.
-    com->communityNumber = communityNumber;
-    com->visited = visited;
-    int communitySize = 0;
-    //Calculate how many nodes are in each community
-    for(i=0;i<communityNumber;i++){
-        communitySize = 0;
-        for(j=0; j<nodeCount; j++){
-            if(visited[j] == i){
-                communitySize++;
-            }
+    graph->integerWeights = 1;
+    for (i = 0; i < graph->edgeCount; i++) {
+        double weight = graph->edgeWeights[i];
+        if (weight != floor(weight) || weight > BUCKET_QUEUE_LIMIT) {
+            graph->integerWeights = 0;
+            graph->maxWeight = 0;
+            return;
         }
-        if(communitySize <= t){
-            //If there are less than or equal to t nodes in a community than stop the algorithm
-            com->isEnd = 1;
-            return com;
+        if (weight > graph->maxWeight) {
+            graph->maxWeight = (int)weight;
         }
     }
-    com->isEnd = 0;
-    return com;
 }
 
-int main() {
-    struct Node* graph[MAX_NODES];
-    int nodeCount = 0;
+/*
+@brief compares two adjacency entries by target and then by weight, used by qsort
+*/
+int compareAdjacencyEntry(const void* a, const void* b) {
+    const struct AdjacencyEntry* x = (const struct AdjacencyEntry*)a;
+    const struct AdjacencyEntry* y = (const struct AdjacencyEntry*)b;
+    if (x->target != y->target) {
+        return (x->target > y->target) - (x->target < y->target);
+    }
+    return (x->weight > y->weight) - (x->weight < y->weight);
+}
 
-    readGraph(graph, &nodeCount, "input.txt");
-    printGraph(graph, nodeCount);
+/*
+@brief compares two ranked edges for qsort, edges with higher betweenness come first and ties are ordered by edge id
+@param a first edge
+@param b second edge
+@return negative if a comes first, positive if b comes first
+*/
+int compareRankedEdge(const void* a, const void* b) {
+    const struct RankedEdge* x = (const struct RankedEdge*)a;
+    const struct RankedEdge* y = (const struct RankedEdge*)b;
+    if (x->value != y->value) {
+        return x->value > y->value ? -1 : 1;
+    }
+    return x->edge - y->edge;
+}
 
-    int i,j,kValue,tValue;
-    printf("\nEnter k value: ");
-    scanf("%d",&kValue);
-    printf("Enter t value: ");
-    scanf("%d",&tValue);
-    printf("\n");
+/*
+@brief checks if an edge is still in graph
+@param graph graph of edge
+@param edge edge id
+@return 1 if the edge is not removed, 0 otherwise
+*/
+int isEdgeAlive(struct Graph* graph, int edge) {
+    return (graph->alive[edge >> 6] >> (edge & 63)) & 1;
+}
 
-    struct Community* com = NULL;
-    int lastCommunityNumber = 0;
-    int repeatedCommunityNumberCounter = 1;
-    int flag = 0;
-    //Calculate community number of given graph
-    com = calculateCommunityNumber(graph,nodeCount,tValue);
-    if(com->isEnd == 1){
-        flag = 1;
-        printf("\nProgram terminated due to t value!\n");
+/*
+@brief builds the alive bitmap of graph, an edge is alive if it has a slot whose target is not -1
+@param graph graph whose adjacency and edge ids are set
+*/
+void initAliveEdges(struct Graph* graph) {
+    int k;
+    graph->alive = (uint64_t*)calloc(graph->edgeCount / 64 + 1, sizeof(uint64_t));
+    for (k = 0; k < graph->slotCount; k++) {
+        if (graph->targets[k] != -1) {
+            graph->alive[graph->edgeIds[k] >> 6] |= 1ULL << (graph->edgeIds[k] & 63);
+        }
     }
-    lastCommunityNumber = com->communityNumber;
-    int iteration = 1;
+    graph->deadSlots = 0;
+    for (k = 0; k < graph->slotCount; k++) {
+        if (graph->targets[k] == -1 || !isEdgeAlive(graph, graph->edgeIds[k])) {
+            graph->deadSlots++;
+        }
+    }
+}
 
-    while(flag == 0){
-        printf("\n------------------------------ ITERATION %d ------------------------------\n",iteration);
-        free(com);
-        findShortestPathAndCalculateEdgeBetweenness(graph,nodeCount);
-        com = calculateCommunityNumber(graph,nodeCount,tValue);
-        if(com->isEnd == 1){
-            flag = 1;
-            printf("\nProgram terminated due to t value!\n");
+/*
+@brief removes the slots of removed edges from the adjacency, rows are moved to the left in place and keep their
+        order. Edge ids do not change
+@param graph graph to compact
+*/
+void compactGraph(struct Graph* graph) {
+    int i, k, start, end;
+    int position = 0;
+    for (i = 0; i < graph->nodeCount; i++) {
+        start = graph->offsets[i];
+        end = graph->offsets[i + 1];
+        graph->offsets[i] = position;
+        for (k = start; k < end; k++) {
+            if (graph->targets[k] != -1 && isEdgeAlive(graph, graph->edgeIds[k])) {
+                graph->targets[position] = graph->targets[k];
+                graph->edgeIds[position] = graph->edgeIds[k];
+                if (graph->weights != NULL) {
+                    graph->weights[position] = graph->weights[k];
+                }
+                position++;
+            }
         }
-        if(com->communityNumber == lastCommunityNumber){
-            //If the number of communities is same previous one
-            repeatedCommunityNumberCounter++;
-        }else{
-            //If it's not the same as before reset counter
-            repeatedCommunityNumberCounter = 1;
+    }
+    graph->offsets[graph->nodeCount] = position;
+    graph->slotCount = position;
+    graph->deadSlots = 0;
+}
+
+/*
+@brief builds CSR adjacency of graph from an edge list. Every edge is added in both directions,
+        duplicate edges and self loops are dropped. If the list is weighted, the smallest weight of duplicates is kept
+@param graph graph to build, nodeCount and names must be set
+@param list edge list
+*/
+void buildAdjacency(struct Graph* graph, struct EdgeList* list) {
+    int i, j, k, u, v;
+    int* position = (int*)malloc(sizeof(int) * (graph->nodeCount + 1));
+    graph->offsets = (int*)calloc(graph->nodeCount + 1, sizeof(int));
+
+    //Count degrees, then prefix sums give the start of every row
+    for (i = 0; i < list->count; i++) {
+        if (list->edges[2 * i] != list->edges[2 * i + 1]) {
+            graph->offsets[list->edges[2 * i] + 1]++;
+            graph->offsets[list->edges[2 * i + 1] + 1]++;
         }
-        if(repeatedCommunityNumberCounter == kValue){
-            //If the number of communities is same k times than stop the algorithm
-            flag = 1;
-            printf("\nProgram terminated due to k value!\n");
+    }
+    for (i = 0; i < graph->nodeCount; i++) {
+        graph->offsets[i + 1] += graph->offsets[i];
+    }
+    graph->targets = (int32_t*)malloc(sizeof(int32_t) * (graph->offsets[graph->nodeCount] + 1));
+    graph->weights = NULL;
+    graph->edgeWeights = NULL;
+    if (list->weighted) {
+        graph->weights = (double*)malloc(sizeof(double) * (graph->offsets[graph->nodeCount] + 1));
+    }
+    memcpy(position, graph->offsets, sizeof(int) * (graph->nodeCount + 1));
+    for (i = 0; i < list->count; i++) {
+        u = list->edges[2 * i];
+        v = list->edges[2 * i + 1];
+        if (u != v) {
+            if (list->weighted) {
+                graph->weights[position[u]] = list->weights[i];
+                graph->weights[position[v]] = list->weights[i];
+            }
+            graph->targets[position[u]++] = v;
+            graph->targets[position[v]++] = u;
         }
-        lastCommunityNumber = com->communityNumber;
+    }
 
-        //Print number of communities and community nodes
-        printf("\nNumber of communities: %d\n",lastCommunityNumber);
-        for(i=0;i<lastCommunityNumber;i++){
-            printf("Community %d: ",i+1);
-            for(j=0; j<nodeCount; j++){
-                if(com->visited[j] == i){
-                    printf("%c ",graph[j]->data);
+    //Sort every row and remove duplicates, rows are compacted to the left
+    int maxDegree = 0;
+    for (i = 0; i < graph->nodeCount; i++) {
+        if (graph->offsets[i + 1] - graph->offsets[i] > maxDegree) {
+            maxDegree = graph->offsets[i + 1] - graph->offsets[i];
+        }
+    }
+    struct AdjacencyEntry* row = (struct AdjacencyEntry*)malloc(sizeof(struct AdjacencyEntry) * (maxDegree + 1));
+    k = 0;
+    for (i = 0; i < graph->nodeCount; i++) {
+        int start = graph->offsets[i];
+        int end = graph->offsets[i + 1];
+        graph->offsets[i] = k;
+        if (list->weighted) {
+            for (j = start; j < end; j++) {
+                row[j - start].target = graph->targets[j];
+                row[j - start].weight = graph->weights[j];
+            }
+            qsort(row, end - start, sizeof(struct AdjacencyEntry), compareAdjacencyEntry);
+            for (j = 0; j < end - start; j++) {
+                if (j == 0 || row[j].target != row[j - 1].target) {
+                    graph->targets[k] = row[j].target;
+                    graph->weights[k++] = row[j].weight;
+                }
+            }
+        } else {
+            qsort(graph->targets + start, end - start, sizeof(int32_t), compareNodeId);
+            for (j = start; j < end; j++) {
+                if (j == start || graph->targets[j] != graph->targets[j - 1]) {
+                    graph->targets[k++] = graph->targets[j];
                 }
             }
-            printf("\n");
         }
-        printf("\n");
-        iteration++;
     }
-    
+    graph->offsets[graph->nodeCount] = k;
+    graph->slotCount = k;
+    free(row);
+    free(position);
 
-    // Belleği serbest bırak
-    for (i = 0; i < nodeCount; i++) {
-        free(graph[i]);
+    //Give ids to edges, the slot (i, j) with i < j gets a new id and the slot (j, i) finds it with binary search
+    graph->edgeCount = 0;
+    graph->edgeIds = (int32_t*)malloc(sizeof(int32_t) * (graph->slotCount + 1));
+    graph->edgeEnds = (int32_t*)malloc(sizeof(int32_t) * (graph->slotCount + 1));
+    if (list->weighted) {
+        graph->edgeWeights = (double*)malloc(sizeof(double) * (graph->slotCount / 2 + 1));
     }
-    free(com);
+    for (i = 0; i < graph->nodeCount; i++) {
+        for (j = graph->offsets[i]; j < graph->offsets[i + 1]; j++) {
+            int neighbor = graph->targets[j];
+            if (i < neighbor) {
+                graph->edgeEnds[2 * graph->edgeCount] = i;
+                graph->edgeEnds[2 * graph->edgeCount + 1] = neighbor;
+                if (list->weighted) {
+                    graph->edgeWeights[graph->edgeCount] = graph->weights[j];
+                }
+                graph->edgeIds[j] = graph->edgeCount++;
+            } else {
+                int32_t* reverse = (int32_t*)bsearch(&i, graph->targets + graph->offsets[neighbor],
+                    graph->offsets[neighbor + 1] - graph->offsets[neighbor], sizeof(int32_t), compareNodeId);
+                graph->edgeIds[j] = graph->edgeIds[reverse - graph->targets];
+            }
+        }
+    }
+    setWeightType(graph);
+    initAliveEdges(graph);
+}
+
+/*
+@brief adds an edge to an edge list, the list is grown when full
+@param list edge list
+@param u first node of edge
+@param v second node of edge
+@param weight weight of edge
+*/
+void addEdge(struct EdgeList* list, int u, int v, double weight) {
+    if (list->count == list->capacity) {
+        list->capacity *= 2;
+        list->edges = (int32_t*)realloc(list->edges, sizeof(int32_t) * 2 * list->capacity);
+        list->weights = (double*)realloc(list->weights, sizeof(double) * list->capacity);
+    }
+    list->edges[2 * list->count] = u;
+    list->edges[2 * list->count + 1] = v;
+    list->weights[list->count] = weight;
+    list->count++;
+}
+
+/*
+@brief parses the weight of an edge
+@param start first character of weight
+@param end end of weight
+@param weight parsed weight
+@return 1 if weight is a positive number, 0 otherwise
+*/
+int parseWeight(const char* start, const char* end, double* weight) {
+    char buffer[64];
+    char* parsedEnd;
+    if (end - start <= 0 || end - start >= (long)sizeof(buffer)) {
+        return 0;
+    }
+    memcpy(buffer, start, end - start);
+    buffer[end - start] = '\0';
+    *weight = strtod(buffer, &parsedEnd);
+    return *parsedEnd == '\0' && *weight > 0 && isfinite(*weight);
+}
+
+/*
+@brief gives the next line rank to a node that starts an adjacency line, ids seen for the first time are
+        marked as not ranked
+@param headRank ranks of nodes, it is grown to cover count ids
+@param headCapacity capacity of headRank
+@param rankedCount number of ids whose rank is set
+@param headCount number of ranked nodes
+@param count number of ids
+@param node node that starts a line, -1 to only mark the new ids
+*/
+void markHead(int** headRank, int* headCapacity, int* rankedCount, int* headCount, int count, int node) {
+    while (*headCapacity < count) {
+        *headCapacity *= 2;
+        *headRank = (int*)realloc(*headRank, sizeof(int) * (*headCapacity));
+    }
+    while (*rankedCount < count) {
+        (*headRank)[(*rankedCount)++] = -1;
+    }
+    if (node != -1 && (*headRank)[node] == -1) {
+        (*headRank)[node] = (*headCount)++;
+    }
+}
+
+/*
+@brief reads graph from file. The file is memory mapped and parsed in one pass without copying lines.
+        Every line is either an adjacency line of the form "node:neighbor1,neighbor2,...;" or an edge "u v".
+        Neighbors can be written as "neighbor=weight" and edges as "u v weight", then the graph is weighted and
+        edges without a weight have weight 1. Empty lines and lines starting with '#' or '%' are skipped. Node names can be any string without
+        separators. Nodes that start an adjacency line get the first ids in the order of lines, so the
+        order of the nodes follows the file
+@param graph graph to read
+@param filename file name to read
+*/
+void readGraph(struct Graph* graph, const char* filename) {
+    int fd = open(filename, O_RDONLY);
+    if (fd == -1) {
+        perror("File error!");
+        exit(EXIT_FAILURE);
+    }
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) == -1) {
+        perror("File error!");
+        exit(EXIT_FAILURE);
+    }
+    size_t size = (size_t)fileStat.st_size;
+    const char* data = "";
+    if (size > 0) {
+        data = (const char*)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            perror("File error!");
+            exit(EXIT_FAILURE);
+        }
+        madvise((void*)data, size, MADV_SEQUENTIAL);
+    }
+
+    struct NameTable table;
+    initNameTable(&table);
+    struct EdgeList list;
+    list.capacity = 1024;
+    list.count = 0;
+    list.weighted = 0;
+    list.edges = (int32_t*)malloc(sizeof(int32_t) * 2 * list.capacity);
+    list.weights = (double*)malloc(sizeof(double) * list.capacity);
+    double weight;
+    int lineNumber = 0;
+    int headCapacity = 1024;
+    int headCount = 0;
+    int rankedCount = 0;
+    int* headRank = (int*)malloc(sizeof(int) * headCapacity);//Line order of the nodes that start an adjacency line, -1 for others
+    const char* p = data;
+    const char* end = data + size;
+    const char* lineEnd;
+    const char* tokenStart;
+    const char* tokenEnd;
+    int node, i;
+
+    while (p < end) {
+        lineNumber++;
+        lineEnd = (const char*)memchr(p, '\n', end - p);
+        if (lineEnd == NULL) {
+            lineEnd = end;
+        }
+        while (p < lineEnd && isSpace(*p)) {
+            p++;
+        }
+        if (p == lineEnd || *p == '#' || *p == '%') {
+            p = lineEnd + 1;
+            continue;
+        }
+
+        const char* colon = (const char*)memchr(p, ':', lineEnd - p);
+        if (colon != NULL) {
+            //Adjacency line
+            tokenEnd = colon;
+            while (tokenEnd > p && isSpace(tokenEnd[-1])) {
+                tokenEnd--;
+            }
+            node = internName(&table, p, tokenEnd - p);
+            markHead(&headRank, &headCapacity, &rankedCount, &headCount, table.count, node);
+
+            //Read neighbors until ';' or end of line
+            p = colon + 1;
+            while (p < lineEnd && *p != ';') {
+                while (p < lineEnd && (isSpace(*p) || *p == ',')) {
+                    p++;
+                }
+                tokenStart = p;
+                while (p < lineEnd && *p != ',' && *p != ';') {
+                    p++;
+                }
+                tokenEnd = p;
+                while (tokenEnd > tokenStart && isSpace(tokenEnd[-1])) {
+                    tokenEnd--;
+                }
+                if (tokenEnd > tokenStart) {
+                    //A neighbor can have a weight in the form neighbor=weight
+                    const char* equals = (const char*)memchr(tokenStart, '=', tokenEnd - tokenStart);
+                    weight = 1;
+                    if (equals != NULL) {
+                        if (!parseWeight(equals + 1, tokenEnd, &weight)) {
+                            printf("Invalid weight in line %d of %s!\n", lineNumber, filename);
+                            exit(EXIT_FAILURE);
+                        }
+                        list.weighted = 1;
+                        tokenEnd = equals;
+                        while (tokenEnd > tokenStart && isSpace(tokenEnd[-1])) {
+                            tokenEnd--;
+                        }
+                    }
+                    addEdge(&list, node, internName(&table, tokenStart, tokenEnd - tokenStart), weight);
+                }
+            }
+        } else {
+            //Edge line "u v" or "u v weight", a line with a single name adds an isolated node
+            tokenStart = p;
+            while (p < lineEnd && !isSpace(*p)) {
+                p++;
+            }
+            node = internName(&table, tokenStart, p - tokenStart);
+            while (p < lineEnd && isSpace(*p)) {
+                p++;
+            }
+            tokenStart = p;
+            while (p < lineEnd && !isSpace(*p)) {
+                p++;
+            }
+            if (p > tokenStart) {
+                int neighbor = internName(&table, tokenStart, p - tokenStart);
+                weight = 1;
+                while (p < lineEnd && isSpace(*p)) {
+                    p++;
+                }
+                tokenStart = p;
+                while (p < lineEnd && !isSpace(*p)) {
+                    p++;
+                }
+                if (p > tokenStart) {
+                    if (!parseWeight(tokenStart, p, &weight)) {
+                        printf("Invalid weight in line %d of %s!\n", lineNumber, filename);
+                        exit(EXIT_FAILURE);
+                    }
+                    list.weighted = 1;
+                }
+                addEdge(&list, node, neighbor, weight);
+            }
+        }
+        p = lineEnd + 1;
+    }
+    if (size > 0) {
+        munmap((void*)data, size);
+    }
+    close(fd);
+    markHead(&headRank, &headCapacity, &rankedCount, &headCount, table.count, -1);
+
+    //Nodes that start an adjacency line come first, the other nodes follow in the order they are seen
+    int* newId = (int*)malloc(sizeof(int) * (table.count + 1));
+    int next = headCount;
+    for (i = 0; i < table.count; i++) {
+        newId[i] = headRank[i] != -1 ? headRank[i] : next++;
+    }
+    for (i = 0; i < 2 * list.count; i++) {
+        list.edges[i] = newId[list.edges[i]];
+    }
+    graph->nodeCount = table.count;
+    graph->nameData = table.data;
+    graph->mapping = NULL;
+    graph->names = (char**)malloc(sizeof(char*) * (table.count + 1));
+    for (i = 0; i < table.count; i++) {
+        graph->names[newId[i]] = table.data + table.nameOffsets[i];
+    }
+    free(newId);
+    free(headRank);
+    free(table.slots);
+    free(table.nameOffsets);
+    free(table.nameLengths);
+
+    buildAdjacency(graph, &list);
+    free(list.edges);
+    free(list.weights);
+}
+
+/*
+@brief frees the memory of graph
+@param graph graph to free
+*/
+void freeGraph(struct Graph* graph) {
+    free(graph->names);
+    free(graph->alive);
+    if (graph->mapping != NULL) {
+        //Arrays of a graph read from a snapshot point into the mapping
+        munmap(graph->mapping, graph->mappingSize);
+        return;
+    }
+    free(graph->nameData);
+    free(graph->offsets);
+    free(graph->targets);
+    free(graph->edgeIds);
+    free(graph->edgeEnds);
+    free(graph->weights);
+    free(graph->edgeWeights);
+}
+
+/*
+@brief checks if a file is a binary graph snapshot
+@param filename file name to check
+@return 1 if the file starts with the snapshot magic, 0 otherwise
+*/
+int isSnapshot(const char* filename) {
+    char magic[8];
+    FILE* file = fopen(filename, "rb");
+    int result = 0;
+    if (file != NULL) {
+        result = fread(magic, 1, sizeof(magic), file) == sizeof(magic) && memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) == 0;
+        fclose(file);
+    }
+    return result;
+}
+
+/*
+@brief writes an array to a snapshot file and pads it to 8 bytes
+@param file file to write
+@param data array to write
+@param size size of array in bytes
+@param position position in file, it is moved to the end of the padded array
+@return position of the array in file
+*/
+uint64_t writeSnapshotSection(FILE* file, const void* data, size_t size, uint64_t* position) {
+    static const char padding[8] = {0};
+    uint64_t start = *position;
+    if (size > 0) {
+        fwrite(data, 1, size, file);
+    }
+    fwrite(padding, 1, (8 - size % 8) % 8, file);
+    *position += size + (8 - size % 8) % 8;
+    return start;
+}
+
+/*
+@brief writes graph to a binary snapshot. The file is written to a temporary file first and renamed,
+        so an interrupted write never leaves a broken snapshot behind
+@param graph graph to write, it is compacted first so the removed edges are not written
+@param filename file name to write
+@param checkpoint state of the Girvan-Newman loop, it is restored when the snapshot is read
+*/
+void writeSnapshot(struct Graph* graph, const char* filename, struct Checkpoint* checkpoint) {
+    char temporary[strlen(filename) + 5];
+    sprintf(temporary, "%s.tmp", filename);
+    FILE* file = fopen(temporary, "wb");
+    if (!file) {
+        perror("Snapshot error!");
+        exit(EXIT_FAILURE);
+    }
+
+    struct SnapshotHeader header;
+    int i;
+    uint64_t position = sizeof(header);
+    if (graph->deadSlots > 0) {
+        compactGraph(graph);
+    }
+    uint64_t* nameOffsets = (uint64_t*)malloc(sizeof(uint64_t) * (graph->nodeCount + 1));
+    uint64_t nameDataLength = 0;
+    for (i = 0; i < graph->nodeCount; i++) {
+        nameOffsets[i] = nameDataLength;
+        nameDataLength += strlen(graph->names[i]) + 1;
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.nodeCount = graph->nodeCount;
+    header.slotCount = graph->slotCount;
+    header.edgeCount = graph->edgeCount;
+    header.iteration = checkpoint->iteration;
+    header.repeatedCommunityNumberCounter = checkpoint->repeatedCommunityNumberCounter;
+    header.nameDataLength = nameDataLength;
+    fwrite(&header, sizeof(header), 1, file);
+
+    header.offsetsPosition = writeSnapshotSection(file, graph->offsets, sizeof(int32_t) * (graph->nodeCount + 1), &position);
+    header.targetsPosition = writeSnapshotSection(file, graph->targets, sizeof(int32_t) * graph->slotCount, &position);
+    header.edgeIdsPosition = writeSnapshotSection(file, graph->edgeIds, sizeof(int32_t) * graph->slotCount, &position);
+    header.edgeEndsPosition = writeSnapshotSection(file, graph->edgeEnds, sizeof(int32_t) * 2 * graph->edgeCount, &position);
+    header.nameOffsetsPosition = writeSnapshotSection(file, nameOffsets, sizeof(uint64_t) * graph->nodeCount, &position);
+    if (graph->weights != NULL) {
+        header.weighted = 1;
+        header.weightsPosition = writeSnapshotSection(file, graph->weights, sizeof(double) * graph->slotCount, &position);
+        header.edgeWeightsPosition = writeSnapshotSection(file, graph->edgeWeights, sizeof(double) * graph->edgeCount, &position);
+    }
+    header.nameDataPosition = position;
+    for (i = 0; i < graph->nodeCount; i++) {
+        fwrite(graph->names[i], 1, strlen(graph->names[i]) + 1, file);
+    }
+    position += nameDataLength;
+    header.fileSize = position;
+
+    //Header is written again with the positions of the sections
+    fseek(file, 0, SEEK_SET);
+    fwrite(&header, sizeof(header), 1, file);
+    free(nameOffsets);
+    if (fclose(file) != 0 || rename(temporary, filename) != 0) {
+        perror("Snapshot error!");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/*
+@brief checks whether a section of a snapshot lies inside the file
+@param position position of the section
+@param count number of elements of the section
+@param elementSize size of an element
+@param size size of the file
+@return 1 if the section is inside the file and aligned to 8 bytes, 0 otherwise
+*/
+int isSectionInside(uint64_t position, uint64_t count, size_t elementSize, size_t size) {
+    return position % 8 == 0 && position <= size && count <= (size - position) / elementSize;
+}
+
+/*
+@brief checks the header and the sections of a mapped snapshot, every position, count and index that is used
+        as a pointer into the mapping must lie inside the file
+@param data mapped snapshot
+@param size size of the file
+@return 1 if the snapshot is valid, 0 otherwise
+*/
+int isValidSnapshot(const char* data, size_t size) {
+    const struct SnapshotHeader* header = (const struct SnapshotHeader*)data;
+    if (size < sizeof(struct SnapshotHeader) || memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != SNAPSHOT_VERSION || header->fileSize != size) {
+        return 0;
+    }
+    if (header->nodeCount < 0 || header->nodeCount >= INT_MAX || header->slotCount < 0 || header->slotCount > INT_MAX ||
+        header->edgeCount < 0 || header->edgeCount > INT_MAX / 2) {
+        return 0;
+    }
+    uint64_t nodeCount = (uint64_t)header->nodeCount;
+    uint64_t slotCount = (uint64_t)header->slotCount;
+    uint64_t edgeCount = (uint64_t)header->edgeCount;
+    if (!isSectionInside(header->offsetsPosition, nodeCount + 1, sizeof(int32_t), size) ||
+        !isSectionInside(header->targetsPosition, slotCount, sizeof(int32_t), size) ||
+        !isSectionInside(header->edgeIdsPosition, slotCount, sizeof(int32_t), size) ||
+        !isSectionInside(header->edgeEndsPosition, 2 * edgeCount, sizeof(int32_t), size) ||
+        !isSectionInside(header->nameOffsetsPosition, nodeCount, sizeof(uint64_t), size) ||
+        header->nameDataPosition > size || header->nameDataLength != size - header->nameDataPosition) {
+        return 0;
+    }
+    if (header->weighted && (!isSectionInside(header->weightsPosition, slotCount, sizeof(double), size) ||
+                             !isSectionInside(header->edgeWeightsPosition, edgeCount, sizeof(double), size))) {
+        return 0;
+    }
+
+    const int32_t* offsets = (const int32_t*)(data + header->offsetsPosition);
+    const int32_t* targets = (const int32_t*)(data + header->targetsPosition);
+    const int32_t* edgeIds = (const int32_t*)(data + header->edgeIdsPosition);
+    const int32_t* edgeEnds = (const int32_t*)(data + header->edgeEndsPosition);
+    const uint64_t* nameOffsets = (const uint64_t*)(data + header->nameOffsetsPosition);
+    const char* nameData = data + header->nameDataPosition;
+    uint64_t i;
+    //Rows must be in order inside the slots, old snapshots mark removed slots with target -1
+    if (offsets[0] != 0 || (uint64_t)offsets[nodeCount] > slotCount) {
+        return 0;
+    }
+    for (i = 0; i < nodeCount; i++) {
+        if (offsets[i] > offsets[i + 1]) {
+            return 0;
+        }
+    }
+    for (i = 0; i < slotCount; i++) {
+        if (targets[i] < -1 || targets[i] >= (int64_t)nodeCount ||
+            (targets[i] != -1 && (edgeIds[i] < 0 || edgeIds[i] >= (int64_t)edgeCount))) {
+            return 0;
+        }
+    }
+    for (i = 0; i < 2 * edgeCount; i++) {
+        if (edgeEnds[i] < 0 || edgeEnds[i] >= (int64_t)nodeCount) {
+            return 0;
+        }
+    }
+    //Every name must start inside the name data and end with its terminating zero before the end of the file
+    if (nodeCount > 0 && (header->nameDataLength == 0 || nameData[header->nameDataLength - 1] != '\0')) {
+        return 0;
+    }
+    for (i = 0; i < nodeCount; i++) {
+        if (nameOffsets[i] >= header->nameDataLength) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/*
+@brief reads graph from a binary snapshot. The file is memory mapped and the adjacency arrays point into the
+        mapping without copying, only the pointers to the names are built. The mapping is private, so removing
+        edges does not change the file
+@param graph graph to read
+@param filename file name to read
+@param checkpoint state of the Girvan-Newman loop saved in the snapshot
+*/
+void readSnapshot(struct Graph* graph, const char* filename, struct Checkpoint* checkpoint) {
+    int fd = open(filename, O_RDONLY);
+    struct stat fileStat;
+    if (fd == -1 || fstat(fd, &fileStat) == -1) {
+        perror("Snapshot error!");
+        exit(EXIT_FAILURE);
+    }
+    size_t size = (size_t)fileStat.st_size;
+    char* data = (char*)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        perror("Snapshot error!");
+        exit(EXIT_FAILURE);
+    }
+
+    struct SnapshotHeader* header = (struct SnapshotHeader*)data;
+    if (!isValidSnapshot(data, size)) {
+        printf("%s is not a valid graph snapshot!\n", filename);
+        exit(EXIT_FAILURE);
+    }
+
+    int i;
+    uint64_t* nameOffsets = (uint64_t*)(data + header->nameOffsetsPosition);
+    graph->nodeCount = (int)header->nodeCount;
+    graph->slotCount = (int)header->slotCount;
+    graph->edgeCount = (int)header->edgeCount;
+    graph->offsets = (int*)(data + header->offsetsPosition);
+    graph->targets = (int32_t*)(data + header->targetsPosition);
+    graph->edgeIds = (int32_t*)(data + header->edgeIdsPosition);
+    graph->edgeEnds = (int32_t*)(data + header->edgeEndsPosition);
+    graph->nameData = data + header->nameDataPosition;
+    graph->names = (char**)malloc(sizeof(char*) * (graph->nodeCount + 1));
+    for (i = 0; i < graph->nodeCount; i++) {
+        graph->names[i] = graph->nameData + nameOffsets[i];
+    }
+    graph->weights = NULL;
+    graph->edgeWeights = NULL;
+    if (header->weighted) {
+        graph->weights = (double*)(data + header->weightsPosition);
+        graph->edgeWeights = (double*)(data + header->edgeWeightsPosition);
+    }
+    setWeightType(graph);
+    graph->mapping = data;
+    graph->mappingSize = size;
+    //Snapshots of older versions of the program keep removed edges as slots with target -1
+    initAliveEdges(graph);
+    if (graph->deadSlots > 0) {
+        compactGraph(graph);
+    }
+    checkpoint->iteration = (int)header->iteration;
+    checkpoint->repeatedCommunityNumberCounter = (int)header->repeatedCommunityNumberCounter;
+}
+
+/*
+@brief prints graph
+@param graph graph to print
+*/
+void printGraph(struct Graph* graph) {
+    printf("\nGraph:\n");
+    int i,j;
+    for (i = 0; i < graph->nodeCount; ++i) {
+        printf("%s:", graph->names[i]);
+        for (j = graph->offsets[i]; j < graph->offsets[i + 1]; ++j) {
+            if(isEdgeAlive(graph, graph->edgeIds[j]) && graph->weights != NULL){
+                printf("%s=%g,", graph->names[graph->targets[j]], graph->weights[j]);
+            }else if(isEdgeAlive(graph, graph->edgeIds[j])){
+                printf("%s,", graph->names[graph->targets[j]]);
+            }
+        }
+        printf("\n");
+    }
+    printf("\n");
+}
+
+/*
+@brief removes an edge by clearing its bit in alive, its two slots are skipped until the adjacency is compacted
+@param graph graph to remove edge from
+@param edge id of edge
+*/
+void removeEdge(struct Graph* graph, int edge) {
+    if (isEdgeAlive(graph, edge)) {
+        graph->alive[edge >> 6] &= ~(1ULL << (edge & 63));
+        graph->deadSlots += 2;
+    }
+}
+
+/*
+@brief creates an empty betweenness cache, every community is recalculated in the first iteration
+@param graph graph whose edge betweenness is kept
+@return created cache
+*/
+struct BetweennessCache* createBetweennessCache(struct Graph* graph) {
+    int nodeCount = graph->nodeCount;
+    struct BetweennessCache* cache = (struct BetweennessCache*)malloc(sizeof(struct BetweennessCache));
+    cache->nodeCount = nodeCount;
+    cache->values = (double*)calloc(graph->edgeCount + 1, sizeof(double));
+    cache->dirty = (int*)calloc(nodeCount, sizeof(int));
+    cache->touched = (int*)malloc(sizeof(int) * 2 * (graph->edgeCount + 1));//Endpoints of every removed edge
+    cache->touchedCount = 0;
+    cache->allDirty = 1;
+    cache->accumulators = NULL;
+    cache->accumulatorCount = 0;
+    return cache;
+}
+
+/*
+@brief frees a betweenness cache
+@param cache cache to free
+*/
+void freeBetweennessCache(struct BetweennessCache* cache) {
+    int i;
+    for (i = 0; i < cache->accumulatorCount; i++) {
+        free(cache->accumulators[i]);
+    }
+    free(cache->accumulators);
+    free(cache->values);
+    free(cache->dirty);
+    free(cache->touched);
+    free(cache);
+}
+
+/*
+@brief marks the communities that contain an endpoint of a removed edge as dirty, must be called with the
+        communities calculated after the removal
+@param cache cache to update
+@param com communities of graph after the last removal
+*/
+void updateBetweennessCache(struct BetweennessCache* cache, struct Community* com) {
+    int i;
+    for (i = 0; i < cache->nodeCount; i++) {
+        cache->dirty[i] = 0;
+    }
+    for (i = 0; i < cache->touchedCount; i++) {
+        cache->dirty[com->visited[cache->touched[i]]] = 1;
+    }
+    cache->touchedCount = 0;
+    cache->allDirty = 0;
+}
+
+/*
+@brief allocates the private BFS buffers of a betweenness worker
+@param worker worker to initialize, graph, sources, ranges, threadCount, id and accumulator must be set
+*/
+void initBetweennessWorker(struct BetweennessWorker* worker) {
+    int nodeCount = worker->graph->nodeCount;
+    int i;
+    worker->distance = (int*)malloc(sizeof(int) * nodeCount);
+    worker->parent = (int*)malloc(sizeof(int) * nodeCount);
+    worker->order = (int*)malloc(sizeof(int) * nodeCount);
+    worker->sigma = (double*)malloc(sizeof(double) * nodeCount);
+    worker->delta = (double*)malloc(sizeof(double) * nodeCount);
+    worker->queue = createQueue(nodeCount);
+    worker->visitedEdges = 0;
+    worker->weightedDistance = NULL;
+    worker->buckets = NULL;
+    worker->heap = NULL;
+    for (i = 0; i < nodeCount; i++) {
+        worker->distance[i] = -1;
+        worker->parent[i] = -1;
+        worker->sigma[i] = 0;
+        worker->delta[i] = 0;
+    }
+    if (worker->graph->weights != NULL) {
+        worker->weightedDistance = (double*)malloc(sizeof(double) * (nodeCount + 1));
+        for (i = 0; i < nodeCount; i++) {
+            worker->weightedDistance[i] = INFINITY;
+        }
+        if (worker->graph->integerWeights) {
+            worker->buckets = createBucketQueue(nodeCount, worker->graph->maxWeight);
+        } else {
+            worker->heap = createDaryHeap(nodeCount, worker->weightedDistance);
+        }
+    }
+}
+
+/*
+@brief frees the buffers of a betweenness worker
+@param worker worker to free
+*/
+void freeBetweennessWorker(struct BetweennessWorker* worker) {
+    free(worker->distance);
+    free(worker->parent);
+    free(worker->order);
+    free(worker->sigma);
+    free(worker->delta);
+    freeQueue(worker->queue);
+    free(worker->weightedDistance);
+    if (worker->buckets != NULL) {
+        freeBucketQueue(worker->buckets);
+    }
+    if (worker->heap != NULL) {
+        freeDaryHeap(worker->heap);
+    }
+}
+
+/*
+@brief takes the next source from the worker's own range, when it is empty a source is stolen from the ranges
+        of the other workers, so no thread stays idle while another one still has sources
+@param worker worker that takes a source
+@return index of the source in worker->sources, -1 if all sources are taken
+*/
+int takeSource(struct BetweennessWorker* worker) {
+    int i, victim, index;
+    for (i = 0; i < worker->threadCount; i++) {
+        victim = (worker->id + i) % worker->threadCount;
+        if (atomic_load(&worker->ranges[victim].next) < worker->ranges[victim].end) {
+            index = atomic_fetch_add(&worker->ranges[victim].next, 1);
+            if (index < worker->ranges[victim].end) {
+                return index;
+            }
+        }
+    }
+    return -1;
+}
+
+/*
+@brief prints one of the shortest paths from source to every reachable node, following the parents of the
+        last BFS or Dijkstra of worker
+@param worker worker whose parents are printed
+@param source source node
+*/
+void printShortestPaths(struct BetweennessWorker* worker, int source) {
+    struct Graph* graph = worker->graph;
+    int j, destination;
+    for(j = 0; j < graph->nodeCount; j++){
+        if(j != source && worker->parent[j] != -1){
+            destination = j;
+            printf("Path %s -> %s\n",graph->names[source],graph->names[j]);
+            while(worker->parent[destination] != source){
+                printf("%s - ",graph->names[destination]);
+                destination = worker->parent[destination];
+            }
+            printf("%s - %s\n",graph->names[destination],graph->names[source]);
+        }
+    }
+}
+
+/*
+@brief runs Brandes' algorithm from one source: a BFS counts the shortest paths from source to every node,
+        then the dependencies are accumulated backwards into the worker's accumulator
+@param worker worker that owns the buffers and the accumulator
+@param source source node
+*/
+void calculateSourceDependencies(struct BetweennessWorker* worker, int source) {
+    struct Graph* graph = worker->graph;
+    struct Queue* queue = worker->queue;
+    int* distance = worker->distance;
+    int* parent = worker->parent;
+    int* order = worker->order;
+    double* sigma = worker->sigma;
+    double* delta = worker->delta;
+    int current,neighbor,visitedCount;
+    int j,k;
+    double contribution;
+
+    distance[source]=0;
+    sigma[source]=1;
+    visitedCount = 0;
+    enqueue(queue, source);
+    while(!isEmpty(queue)){
+        current=dequeue(queue);
+        order[visitedCount++]=current;
+        worker->visitedEdges += graph->offsets[current+1]-graph->offsets[current];
+        for(k=graph->offsets[current];k<graph->offsets[current+1];k++){
+            neighbor = graph->targets[k];
+            if(isEdgeAlive(graph, graph->edgeIds[k])){
+                if(distance[neighbor]==-1){
+                    distance[neighbor]=distance[current]+1;
+                    parent[neighbor]=current;
+                    enqueue(queue,neighbor);
+                }
+                if(distance[neighbor]==distance[current]+1){
+                    //Every shortest path to current extends to a shortest path to neighbor
+                    sigma[neighbor]+=sigma[current];
+                }
+            }
+        }
+    }
+
+    if(worker->printPaths){
+        printShortestPaths(worker, source);
+    }
+
+    //Accumulate dependencies in the reverse order of BFS, so every node is processed after its successors
+    for(j = visitedCount-1; j > 0; j--){
+        current = order[j];
+        for(k=graph->offsets[current];k<graph->offsets[current+1];k++){
+            neighbor = graph->targets[k];
+            if(distance[neighbor]==distance[current]-1 && isEdgeAlive(graph, graph->edgeIds[k])){
+                //Share of the paths through current that use the edge (neighbor, current)
+                contribution = sigma[neighbor]/sigma[current]*(1+delta[current]);
+                worker->accumulator[graph->edgeIds[k]]+=llround(contribution*BETWEENNESS_SCALE);
+                delta[neighbor]+=contribution;
+            }
+        }
+    }
+
+    //Reset only the visited nodes for the next source
+    for(j = 0; j < visitedCount; j++){
+        current = order[j];
+        distance[current]=-1;
+        parent[current]=-1;
+        sigma[current]=0;
+        delta[current]=0;
+    }
+}
+
+/*
+@brief checks if two weighted distances are equal. Integer weights are compared exactly and real weights with a
+        relative EPSILON, so paths of the same length are counted as shortest paths together
+@param a first distance
+@param b second distance
+@param exact 1 if the weights are integers
+@return 1 if the distances are equal, 0 otherwise
+*/
+int isSameDistance(double a, double b, int exact) {
+    if (exact) {
+        return a == b;
+    }
+    return fabs(a - b) <= EPSILON * (a > b ? a : b);
+}
+
+/*
+@brief runs Brandes' algorithm from one source on a weighted graph: Dijkstra counts the shortest paths from source
+        to every node, then the dependencies are accumulated backwards into the worker's accumulator. Dijkstra uses
+        the bucket queue of the worker for integer weights and its 4-ary heap for real weights
+@param worker worker that owns the buffers and the accumulator
+@param source source node
+*/
+void calculateWeightedSourceDependencies(struct BetweennessWorker* worker, int source) {
+    struct Graph* graph = worker->graph;
+    int* state = worker->distance;//-1 if not reached, 0 if in queue, 1 if settled
+    double* distance = worker->weightedDistance;
+    int* parent = worker->parent;
+    int* order = worker->order;
+    double* sigma = worker->sigma;
+    double* delta = worker->delta;
+    int exact = graph->integerWeights;
+    int current,neighbor,visitedCount,queueSize;
+    int j,k;
+    double newDistance,contribution;
+
+    distance[source]=0;
+    sigma[source]=1;
+    state[source]=0;
+    visitedCount = 0;
+    if(exact){
+        worker->buckets->current = 0;
+        bucketQueuePush(worker->buckets, source, 0);
+    }else{
+        daryHeapPush(worker->heap, source);
+    }
+    queueSize = 1;
+    while(queueSize > 0){
+        current = exact ? bucketQueuePop(worker->buckets) : daryHeapPop(worker->heap);
+        queueSize--;
+        state[current]=1;
+        order[visitedCount++]=current;
+        worker->visitedEdges += graph->offsets[current+1]-graph->offsets[current];
+        for(k=graph->offsets[current];k<graph->offsets[current+1];k++){
+            neighbor = graph->targets[k];
+            if(state[neighbor] == 1 || !isEdgeAlive(graph, graph->edgeIds[k])){
+                continue;
+            }
+            newDistance = distance[current]+graph->weights[k];
+            if(state[neighbor] == -1 || (newDistance < distance[neighbor] && !isSameDistance(newDistance,distance[neighbor],exact))){
+                //A shorter path is found, paths counted before are not shortest paths
+                if(state[neighbor] == -1){
+                    queueSize++;
+                }
+                state[neighbor]=0;
+                distance[neighbor]=newDistance;
+                sigma[neighbor]=sigma[current];
+                parent[neighbor]=current;
+                if(exact){
+                    bucketQueuePush(worker->buckets, neighbor, (long long)newDistance);
+                }else{
+                    daryHeapPush(worker->heap, neighbor);
+                }
+            }else if(isSameDistance(newDistance,distance[neighbor],exact)){
+                //Every shortest path to current extends to a shortest path to neighbor
+                sigma[neighbor]+=sigma[current];
+            }
+        }
+    }
+
+    if(worker->printPaths){
+        printShortestPaths(worker, source);
+    }
+
+    //Accumulate dependencies in the reverse order of Dijkstra, so every node is processed after its successors
+    for(j = visitedCount-1; j > 0; j--){
+        current = order[j];
+        for(k=graph->offsets[current];k<graph->offsets[current+1];k++){
+            neighbor = graph->targets[k];
+            if(distance[neighbor] < distance[current] && isEdgeAlive(graph, graph->edgeIds[k]) &&
+               isSameDistance(distance[neighbor]+graph->weights[k],distance[current],exact)){
+                //Share of the paths through current that use the edge (neighbor, current)
+                contribution = sigma[neighbor]/sigma[current]*(1+delta[current]);
+                worker->accumulator[graph->edgeIds[k]]+=llround(contribution*BETWEENNESS_SCALE);
+                delta[neighbor]+=contribution;
+            }
+        }
+    }
+
+    //Reset only the visited nodes for the next source
+    for(j = 0; j < visitedCount; j++){
+        current = order[j];
+        state[current]=-1;
+        distance[current]=INFINITY;
+        parent[current]=-1;
+        sigma[current]=0;
+        delta[current]=0;
+    }
+}
+
+/*
+@brief thread function of a betweenness worker, processes sources until all of them are taken
+@param arg worker
+@return NULL
+*/
+void* runBetweennessWorker(void* arg) {
+    struct BetweennessWorker* worker = (struct BetweennessWorker*)arg;
+    int index = takeSource(worker);
+    while (index != -1) {
+        if (worker->graph->weights != NULL) {
+            calculateWeightedSourceDependencies(worker, worker->sources[index]);
+        } else {
+            calculateSourceDependencies(worker, worker->sources[index]);
+        }
+        index = takeSource(worker);
+    }
+    return NULL;
+}
+
+/*
+@brief reads the monotonic clock
+@return current time in seconds
+*/
+double getTime() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+/*
+@brief generates the next pseudo random number with xorshift64*
+@param state state of generator, it must not be 0
+@return random number
+*/
+uint64_t nextRandom(uint64_t* state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 2685821657736338717ULL;
+}
+
+/*
+@brief calculates how many sources are sampled. With epsilon the sample is large enough that, with probability
+        1 - delta, the betweenness of every edge is within epsilon * n(n-1)/2 of its exact value:
+        k >= ln(2 * edgeCount / delta) / (2 * epsilon^2)
+@param options sampling settings
+@param edgeCount number of edges
+@param sourceCount number of sources that can be sampled
+@return sample size, sourceCount if all sources are used
+*/
+int calculateSampleCount(struct BetweennessOptions* options, int edgeCount, int sourceCount) {
+    double count = sourceCount;
+    if (options->sampleCount > 0) {
+        count = options->sampleCount;
+    } else if (options->epsilon > 0) {
+        count = ceil(log(2.0 * (edgeCount > 0 ? edgeCount : 1) / options->delta) / (2 * options->epsilon * options->epsilon));
+    }
+    return count < sourceCount ? (int)count : sourceCount;
+}
+
+/*
+@brief finds shortest paths and calculates edge betweenness then removes the edges that have highest edge betweenness.
+        Edge betweenness is calculated with Brandes' algorithm: one BFS per source node counts the shortest paths
+        to every other node, then the pair dependencies are accumulated backwards over all shortest paths.
+        Only the sources in dirty communities of cache are processed, the other edges keep their cached values.
+        Sources are shared between threads, every thread sums into its own accumulator and the
+        accumulators are merged at the end. Sums are kept in fixed point, so the result does not depend on the
+        thread count or on which thread processed which source.
+        If sampling is enabled only a random sample of the sources is processed and the sums are scaled by
+        (number of sources / sample size), the bound of the error is printed with the removed edges
+@param graph graph to find shortest path and calculate edge betweenness
+@param cache betweenness values of the previous iteration
+@param com communities of graph
+@param options thread count and sampling settings, paths are printed only if there is one thread and quiet is 0
+@param stats timings and search counts of this iteration are written to it
+*/
+void findShortestPathAndCalculateEdgeBetweenness(struct Graph* graph, struct BetweennessCache* cache, struct Community* com, struct BetweennessOptions* options, struct IterationStats* stats) {
+
+    int nodeCount = graph->nodeCount;
+    int threadCount = options->threadCount;
+    double* edgeBetweenness = cache->values;
+    int i,j,k,t,e;
+    long long total;
+    int sourceCount = 0;
+    double startTime = getTime();
+    int* sources = (int*)malloc(sizeof(int) * (nodeCount + 1));
+    for(i=0;i<nodeCount;i++){
+        if(cache->allDirty || cache->dirty[com->visited[i]]){
+            sources[sourceCount++] = i;
+        }
+    }
+
+    //Choose the sample with a partial Fisher-Yates shuffle of a copy of the sources
+    int sampleCount = calculateSampleCount(options, graph->edgeCount, sourceCount);
+    int* sample = sources;
+    double scale = 1;
+    if(sampleCount < sourceCount){
+        sample = (int*)malloc(sizeof(int) * (sourceCount + 1));
+        memcpy(sample, sources, sizeof(int) * sourceCount);
+        for(i=0;i<sampleCount;i++){
+            j = i + (int)(nextRandom(&options->randomState) % (uint64_t)(sourceCount - i));
+            t = sample[i];
+            sample[i] = sample[j];
+            sample[j] = t;
+        }
+        scale = (double)sourceCount / sampleCount;
+    }
+
+    //The accumulators are allocated once for the whole run and only the entries of dirty edges are cleared after
+    //every merge. A search can reach every edge of its community, so a sparse map per thread could grow as large
+    //as these arrays, and plain indexing keeps the inner loop of the searches free of hashing
+    if(cache->accumulators == NULL){
+        cache->accumulators = (long long**)malloc(sizeof(long long*) * threadCount);
+        for(i=0;i<threadCount;i++){
+            cache->accumulators[i] = (long long*)calloc(graph->edgeCount + 1, sizeof(long long));
+        }
+        cache->accumulatorCount = threadCount;
+    }
+
+    //Split the sources of dirty communities into one contiguous range per thread
+    struct WorkRange* ranges = (struct WorkRange*)malloc(sizeof(struct WorkRange) * threadCount);
+    struct BetweennessWorker* workers = (struct BetweennessWorker*)malloc(sizeof(struct BetweennessWorker) * threadCount);
+    pthread_t* threads = (pthread_t*)malloc(sizeof(pthread_t) * threadCount);
+    for(i=0;i<threadCount;i++){
+        atomic_init(&ranges[i].next, (int)((long long)sampleCount * i / threadCount));
+        ranges[i].end = (int)((long long)sampleCount * (i + 1) / threadCount);
+        workers[i].graph = graph;
+        workers[i].sources = sample;
+        workers[i].ranges = ranges;
+        workers[i].threadCount = threadCount;
+        workers[i].id = i;
+        workers[i].printPaths = (threadCount == 1 && !options->quiet);
+        workers[i].accumulator = cache->accumulators[i];
+        initBetweennessWorker(&workers[i]);
+    }
+    //A thread that can not be started is skipped, its sources are stolen by the running workers
+    int* started = (int*)calloc(threadCount, sizeof(int));
+    for(i=1;i<threadCount;i++){
+        started[i] = pthread_create(&threads[i], NULL, runBetweennessWorker, &workers[i]) == 0;
+    }
+    runBetweennessWorker(&workers[0]);
+    for(i=1;i<threadCount;i++){
+        if(started[i]){
+            pthread_join(threads[i], NULL);
+        }
+    }
+    free(started);
+
+    //Merge the accumulators into the edges of dirty communities, an edge and its endpoints are always in the same community
+    for(j=0;j<sourceCount;j++){
+        i = sources[j];
+        for(k=graph->offsets[i];k<graph->offsets[i+1];k++){
+            if(graph->targets[k] > i){
+                e = graph->edgeIds[k];
+                total = 0;
+                for(t=0;t<threadCount;t++){
+                    total += workers[t].accumulator[e];
+                    workers[t].accumulator[e] = 0;
+                }
+                //Every pair of nodes is counted from both of its ends
+                edgeBetweenness[e] = total/(2*BETWEENNESS_SCALE)*scale;
+            }
+        }
+    }
+    stats->searchCount = sampleCount;
+    stats->visitedEdges = 0;
+    for(i=0;i<threadCount;i++){
+        stats->visitedEdges += workers[i].visitedEdges;
+        freeBetweennessWorker(&workers[i]);
+    }
+    free(workers);
+    free(threads);
+    free(ranges);
+    if(sample != sources){
+        free(sample);
+    }
+    free(sources);
+    stats->betweennessTime = getTime() - startTime;
+    startTime = getTime();
+
+    //Print edge betweenness and find the max value, every edge is visited once from its larger endpoint
+    double max = 0;
+    for(i=0;i<nodeCount;i++){
+        for(k=graph->offsets[i];k<graph->offsets[i+1] && graph->targets[k] < i;k++){
+            if(isEdgeAlive(graph, graph->edgeIds[k])){
+                e = graph->edgeIds[k];
+                if(edgeBetweenness[e] != 0 && !options->quiet){
+                    printf("\nEdge (%s , %s) : %.2f times",graph->names[i],graph->names[graph->targets[k]],edgeBetweenness[e]);
+                }
+                if(edgeBetweenness[e] > max){
+                    max = edgeBetweenness[e];
+                }
+            }
+        }
+    }
+
+    //Find the edges with the highest betweenness, there can be multiple edges that with the highest betweenness
+    //Betweenness values are fractional, so values within a relative EPSILON of the max are counted as ties
+    int maxEdgeCount = 0;
+    int* maxEdges = (int*)malloc(sizeof(int) * (graph->edgeCount + 1));
+    if(options->topCount > 0){
+        //Take the topCount edges with the highest betweenness instead, ties are broken by edge id
+        struct RankedEdge* ranked = (struct RankedEdge*)malloc(sizeof(struct RankedEdge) * (graph->edgeCount + 1));
+        int rankedCount = 0;
+        for(e=0;e<graph->edgeCount;e++){
+            if(isEdgeAlive(graph, e) && edgeBetweenness[e] > 0){
+                ranked[rankedCount].value = edgeBetweenness[e];
+                ranked[rankedCount++].edge = e;
+            }
+        }
+        qsort(ranked, rankedCount, sizeof(struct RankedEdge), compareRankedEdge);
+        for(j=0;j<rankedCount && j<options->topCount;j++){
+            maxEdges[maxEdgeCount++] = ranked[j].edge;
+        }
+        free(ranked);
+    }else{
+        for(i=0;i<nodeCount;i++){
+            for(k=graph->offsets[i];k<graph->offsets[i+1] && graph->targets[k] < i;k++){
+                if(isEdgeAlive(graph, graph->edgeIds[k]) && max > 0 && edgeBetweenness[graph->edgeIds[k]] >= max*(1-EPSILON)){
+                    maxEdges[maxEdgeCount++] = graph->edgeIds[k];
+                }
+            }
+        }
+    }
+
+    //Remove edges with the highest betweenness and print them
+    if(!options->quiet){
+        printf("\n");
+    }
+    for(j=0;j<maxEdgeCount;j++){
+        e = maxEdges[j];
+        if(!options->quiet){
+            printf("\nRemoving edge %s --- %s",graph->names[graph->edgeEnds[2*e+1]],graph->names[graph->edgeEnds[2*e]]);
+        }
+        removeEdge(graph,e);
+        edgeBetweenness[e]=0;
+        cache->touched[cache->touchedCount++]=graph->edgeEnds[2*e];
+        cache->touched[cache->touchedCount++]=graph->edgeEnds[2*e+1];
+    }
+    free(maxEdges);
+    //Later searches skip the slots of removed edges, they are dropped when there are enough of them
+    if(graph->deadSlots * (long long)COMPACTION_RATIO >= graph->slotCount){
+        compactGraph(graph);
+    }
+    stats->removedEdges = maxEdgeCount;
+    stats->removalTime = getTime() - startTime;
+    if(options->quiet){
+        return;
+    }
+    if(sampleCount < sourceCount && maxEdgeCount > 0){
+        //Hoeffding bound with a union bound over all edges: a source adds at most n-1 pairs to an edge
+        double halfWidth = (double)sourceCount * (sourceCount - 1) / 2 *
+            sqrt(log(2.0 * graph->edgeCount / options->delta) / (2.0 * sampleCount));
+        printf("\nBetweenness estimated from %d of %d sources: %.2f +- %.2f with %.0f%% confidence",
+            sampleCount, sourceCount, max, halfWidth, 100 * (1 - options->delta));
+    }
+
+    printf("\n");
+    printGraph(graph);
+}
+
+/*
+@brief finds the root of the set of a node, the path is halved on the way so later searches are shorter
+@param parent parent of every node in union-find forest
+@param node node to find
+@return root of the set of node
+*/
+int findRoot(int* parent, int node) {
+    while (parent[node] != node) {
+        parent[node] = parent[parent[node]];
+        node = parent[node];
+    }
+    return node;
+}
+
+/*
+@brief frees a struct Community
+@param com community to free
+*/
+void freeCommunity(struct Community* com) {
+    free(com->visited);
+    free(com->communitySize);
+    free(com);
+}
+
+/*
+@brief calculates community number, finds which node belongs to which community and
+        checks if there is a community that has less than or equal to t nodes.
+        Communities are the connected components, they are found with union-find: every edge joins the sets of its
+        endpoints (union by size), then one pass over the nodes numbers the sets in the order of their first node
+        and counts their sizes
+@param graph graph to calculate community number
+@param t t value
+@return struct Community that has the information about community number, community nodes, community sizes and
+        if there is a community that has less than or equal to t nodes
+*/
+struct Community* calculateCommunityNumber(struct Graph* graph, int t){
+
+    int nodeCount = graph->nodeCount;
+    int communityNumber = 0;
+    int *visited = (int*)malloc(sizeof(int)*(nodeCount+1));
+    int *parent = (int*)malloc(sizeof(int)*(nodeCount+1));
+    int *size = (int*)malloc(sizeof(int)*(nodeCount+1));
+    int i,j;
+    int u,v;
+    for(i=0;i<nodeCount;i++){
+        parent[i]=i;
+        size[i]=1;
+    }
+    //Join the endpoints of every edge, every edge is seen once from its smaller endpoint
+    for(i = 0; i < nodeCount; i++){
+        for(j=graph->offsets[i];j<graph->offsets[i+1];j++){
+            if(graph->targets[j] > i && isEdgeAlive(graph, graph->edgeIds[j])){
+                u = findRoot(parent,i);
+                v = findRoot(parent,graph->targets[j]);
+                if(u != v){
+                    if(size[u] < size[v]){
+                        parent[u] = v;
+                        size[v] += size[u];
+                    }else{
+                        parent[v] = u;
+                        size[u] += size[v];
+                    }
+                }
+            }
+        }
+    }
+
+    //Number the sets in the order of their first node and count the nodes of every community
+    //size of a root is no longer needed, so size[root] is reused for the community number of the root
+    int *communitySize = (int*)calloc(nodeCount+1,sizeof(int));
+    for(i=0;i<nodeCount;i++){
+        size[i]=-1;
+    }
+    for(i=0;i<nodeCount;i++){
+        u = findRoot(parent,i);
+        if(size[u] == -1){
+            size[u] = communityNumber++;
+        }
+        visited[i] = size[u];
+        communitySize[visited[i]]++;
+    }
+    free(parent);
+    free(size);
+
+    struct Community* com = (struct Community*)malloc(sizeof(struct Community));
+    //The number of communities is equal to the number of connected components.
+    com->communityNumber = communityNumber;
+    com->visited = visited;
+    com->communitySize = communitySize;
+    com->isEnd = 0;
+    for(i=0;i<communityNumber;i++){
+        if(communitySize[i] <= t){
+            //If there are less than or equal to t nodes in a community than stop the algorithm
+            com->isEnd = 1;
+        }
+    }
+    return com;
+}
+
+/*
+@brief prints the number of communities and the nodes of every community
+@param graph graph whose nodes are printed
+@param com communities of graph
+*/
+void printCommunities(struct Graph* graph, struct Community* com) {
+    int i, j;
+    //Group nodes by community with a counting sort, so printing is O(V) for any number of communities
+    int* starts = (int*)calloc(com->communityNumber + 1, sizeof(int));
+    int* members = (int*)malloc(sizeof(int) * (graph->nodeCount + 1));
+    for(j=0; j<graph->nodeCount; j++){
+        starts[com->visited[j] + 1]++;
+    }
+    for(i=0;i<com->communityNumber;i++){
+        starts[i + 1] += starts[i];
+    }
+    for(j=0; j<graph->nodeCount; j++){
+        members[starts[com->visited[j]]++] = j;
+    }
+    printf("\nNumber of communities: %d\n",com->communityNumber);
+    j = 0;
+    for(i=0;i<com->communityNumber;i++){
+        printf("Community %d: ",i+1);
+        for(; j<starts[i]; j++){
+            printf("%s ",graph->names[members[j]]);
+        }
+        printf("\n");
+    }
+    free(starts);
+    free(members);
+}
+
+/*
+@brief calculates the modularity Q of a partition on the graph as it was read, edges removed by Girvan-Newman are
+        still counted. Q = sum over communities of (internal weight / m) - (total degree / 2m)^2, where m is the total
+        weight of edges and every edge has weight 1 in unweighted graphs
+@param graph graph of partition
+@param com community of every node
+@return modularity of partition, 0 if graph has no edges or the sum only differs from 0 by rounding
+*/
+double calculateModularity(struct Graph* graph, struct Community* com) {
+    int e, u, v, c;
+    double m = 0;
+    double q = 0;
+    double weight;
+    double* internal = (double*)calloc(com->communityNumber + 1, sizeof(double));
+    double* degree = (double*)calloc(com->communityNumber + 1, sizeof(double));
+    for (e = 0; e < graph->edgeCount; e++) {
+        weight = graph->edgeWeights != NULL ? graph->edgeWeights[e] : 1;
+        u = com->visited[graph->edgeEnds[2 * e]];
+        v = com->visited[graph->edgeEnds[2 * e + 1]];
+        m += weight;
+        degree[u] += weight;
+        degree[v] += weight;
+        if (u == v) {
+            internal[u] += weight;
+        }
+    }
+    if (m == 0) {
+        free(internal);
+        free(degree);
+        return 0;
+    }
+    for (c = 0; c < com->communityNumber; c++) {
+        q += internal[c] / m - (degree[c] / (2 * m)) * (degree[c] / (2 * m));
+    }
+    free(internal);
+    free(degree);
+    //a single community gives 1 - 1, which may be a tiny negative number that is printed as -0.0000
+    if (fabs(q) < 1e-12) {
+        q = 0;
+    }
+    return q;
+}
+
+/*
+@brief creates the first level of Louvain from graph, edges of unweighted graphs have weight 1
+@param graph graph to convert
+@return weighted graph
+*/
+struct LouvainGraph* createLouvainGraph(struct Graph* graph) {
+    struct LouvainGraph* level = (struct LouvainGraph*)malloc(sizeof(struct LouvainGraph));
+    int i, e;
+    level->nodeCount = graph->nodeCount;
+    level->offsets = (int*)calloc(graph->nodeCount + 1, sizeof(int));
+    level->targets = (int*)malloc(sizeof(int) * (2 * graph->edgeCount + 1));
+    level->weights = (double*)malloc(sizeof(double) * (2 * graph->edgeCount + 1));
+    level->selfLoops = (double*)calloc(graph->nodeCount + 1, sizeof(double));
+    level->degrees = (double*)calloc(graph->nodeCount + 1, sizeof(double));
+    for (e = 0; e < graph->edgeCount; e++) {
+        level->offsets[graph->edgeEnds[2 * e] + 1]++;
+        level->offsets[graph->edgeEnds[2 * e + 1] + 1]++;
+    }
+    for (i = 0; i < graph->nodeCount; i++) {
+        level->offsets[i + 1] += level->offsets[i];
+    }
+    int* position = (int*)malloc(sizeof(int) * (graph->nodeCount + 1));
+    memcpy(position, level->offsets, sizeof(int) * (graph->nodeCount + 1));
+    level->totalWeight = 0;
+    for (e = 0; e < graph->edgeCount; e++) {
+        int u = graph->edgeEnds[2 * e];
+        int v = graph->edgeEnds[2 * e + 1];
+        double weight = graph->edgeWeights != NULL ? graph->edgeWeights[e] : 1;
+        level->targets[position[u]] = v;
+        level->weights[position[u]++] = weight;
+        level->targets[position[v]] = u;
+        level->weights[position[v]++] = weight;
+        level->degrees[u] += weight;
+        level->degrees[v] += weight;
+        level->totalWeight += 2 * weight;
+    }
+    free(position);
+    return level;
+}
+
+/*
+@brief frees a Louvain level
+@param level level to free
+*/
+void freeLouvainGraph(struct LouvainGraph* level) {
+    free(level->offsets);
+    free(level->targets);
+    free(level->weights);
+    free(level->selfLoops);
+    free(level->degrees);
+    free(level);
+}
+
+/*
+@brief moves nodes of a level to the neighbor community with the highest modularity gain. Inserting node i into
+        community c gains k_i,c - tot_c * k_i / 2m, where k_i,c is the weight of the edges between i and c and tot_c
+        is the total degree of c. All nodes are queued at the start, and when a node moves only its neighbors that
+        are not in its new community are queued again, so stable parts of the graph are not scanned over and over
+@param level level to optimize
+@param community community of every node, it starts as one community per node
+@return number of communities, communities are renumbered to 0 ... count-1
+*/
+int moveLouvainNodes(struct LouvainGraph* level, int* community) {
+    int n = level->nodeCount;
+    int i, k, c, best, touchedCount;
+    double gain, bestGain;
+    double* tot = (double*)malloc(sizeof(double) * (n + 1));
+    double* neighborWeight = (double*)malloc(sizeof(double) * (n + 1));
+    int* touched = (int*)malloc(sizeof(int) * (n + 1));
+    char* inQueue = (char*)malloc(n + 1);
+    struct Queue* queue = createQueue(n + 1);
+    for (i = 0; i < n; i++) {
+        community[i] = i;
+        tot[i] = level->degrees[i];
+        neighborWeight[i] = -1;
+        inQueue[i] = 1;
+        enqueue(queue, i);
+    }
+
+    while (!isEmpty(queue)) {
+        i = dequeue(queue);
+        inQueue[i] = 0;
+
+        //Weights from i to its neighbor communities
+        touchedCount = 0;
+        neighborWeight[community[i]] = 0;
+        touched[touchedCount++] = community[i];
+        for (k = level->offsets[i]; k < level->offsets[i + 1]; k++) {
+            c = community[level->targets[k]];
+            if (neighborWeight[c] < 0) {
+                neighborWeight[c] = 0;
+                touched[touchedCount++] = c;
+            }
+            neighborWeight[c] += level->weights[k];
+        }
+
+        //Remove i from its community, then insert it to the best one
+        tot[community[i]] -= level->degrees[i];
+        best = community[i];
+        bestGain = neighborWeight[best] - tot[best] * level->degrees[i] / level->totalWeight;
+        for (k = 0; k < touchedCount; k++) {
+            c = touched[k];
+            gain = neighborWeight[c] - tot[c] * level->degrees[i] / level->totalWeight;
+            if (gain > bestGain + EPSILON) {
+                best = c;
+                bestGain = gain;
+            }
+        }
+        tot[best] += level->degrees[i];
+        for (k = 0; k < touchedCount; k++) {
+            neighborWeight[touched[k]] = -1;
+        }
+        if (best != community[i]) {
+            community[i] = best;
+            for (k = level->offsets[i]; k < level->offsets[i + 1]; k++) {
+                c = level->targets[k];
+                if (!inQueue[c] && community[c] != best) {
+                    inQueue[c] = 1;
+                    enqueue(queue, c);
+                }
+            }
+        }
+    }
+    freeQueue(queue);
+    free(inQueue);
+
+    //Renumber communities in the order of their first node
+    int count = 0;
+    for (i = 0; i < n; i++) {
+        touched[i] = -1;
+    }
+    for (i = 0; i < n; i++) {
+        if (touched[community[i]] == -1) {
+            touched[community[i]] = count++;
+        }
+        community[i] = touched[community[i]];
+    }
+    free(tot);
+    free(neighborWeight);
+    free(touched);
+    return count;
+}
+
+/*
+@brief builds the next Louvain level, every community of level becomes a node. Edges inside a community become
+        a self loop and edges between two communities are merged into one edge
+@param level level to aggregate
+@param community community of every node of level
+@param communityCount number of communities
+@return next level
+*/
+struct LouvainGraph* aggregateLouvainGraph(struct LouvainGraph* level, int* community, int communityCount) {
+    struct LouvainGraph* next = (struct LouvainGraph*)malloc(sizeof(struct LouvainGraph));
+    int n = level->nodeCount;
+    int i, j, k, c, d, node, touchedCount, slot;
+    int* memberOffsets = (int*)calloc(communityCount + 1, sizeof(int));
+    int* members = (int*)malloc(sizeof(int) * (n + 1));
+    double* neighborWeight = (double*)malloc(sizeof(double) * (communityCount + 1));
+    int* touched = (int*)malloc(sizeof(int) * (communityCount + 1));
+
+    //Group nodes by community with a counting sort
+    for (i = 0; i < n; i++) {
+        memberOffsets[community[i] + 1]++;
+    }
+    for (c = 0; c < communityCount; c++) {
+        memberOffsets[c + 1] += memberOffsets[c];
+    }
+    for (i = 0; i < n; i++) {
+        members[memberOffsets[community[i]]++] = i;
+    }
+    for (c = communityCount; c > 0; c--) {
+        memberOffsets[c] = memberOffsets[c - 1];
+    }
+    memberOffsets[0] = 0;
+
+    next->nodeCount = communityCount;
+    next->offsets = (int*)malloc(sizeof(int) * (communityCount + 1));
+    next->targets = (int*)malloc(sizeof(int) * (level->offsets[n] + 1));
+    next->weights = (double*)malloc(sizeof(double) * (level->offsets[n] + 1));
+    next->selfLoops = (double*)calloc(communityCount + 1, sizeof(double));
+    next->degrees = (double*)calloc(communityCount + 1, sizeof(double));
+    next->totalWeight = level->totalWeight;
+    for (c = 0; c < communityCount; c++) {
+        neighborWeight[c] = -1;
+    }
+
+    slot = 0;
+    for (c = 0; c < communityCount; c++) {
+        next->offsets[c] = slot;
+        touchedCount = 0;
+        for (j = memberOffsets[c]; j < memberOffsets[c + 1]; j++) {
+            node = members[j];
+            next->selfLoops[c] += level->selfLoops[node];
+            next->degrees[c] += level->degrees[node];
+            for (k = level->offsets[node]; k < level->offsets[node + 1]; k++) {
+                d = community[level->targets[k]];
+                if (d == c) {
+                    //Internal edges are seen from both ends
+                    next->selfLoops[c] += level->weights[k] / 2;
+                } else {
+                    if (neighborWeight[d] < 0) {
+                        neighborWeight[d] = 0;
+                        touched[touchedCount++] = d;
+                    }
+                    neighborWeight[d] += level->weights[k];
+                }
+            }
+        }
+        for (k = 0; k < touchedCount; k++) {
+            next->targets[slot] = touched[k];
+            next->weights[slot++] = neighborWeight[touched[k]];
+            neighborWeight[touched[k]] = -1;
+        }
+    }
+    next->offsets[communityCount] = slot;
+
+    free(memberOffsets);
+    free(members);
+    free(neighborWeight);
+    free(touched);
+    return next;
+}
+
+/*
+@brief finds communities with the Louvain method. Nodes are moved between communities while modularity increases,
+        then every community is merged into one node and the same is done on the merged graph, until no node moves
+@param graph graph to find communities
+@return struct Community that has the community of every node, isEnd is always 0
+*/
+struct Community* findLouvainCommunities(struct Graph* graph) {
+    struct LouvainGraph* level = createLouvainGraph(graph);
+    struct LouvainGraph* next;
+    int* community = (int*)malloc(sizeof(int) * (graph->nodeCount + 1));
+    int* levelCommunity = (int*)malloc(sizeof(int) * (graph->nodeCount + 1));
+    int i, count;
+    for (i = 0; i < graph->nodeCount; i++) {
+        community[i] = i;
+    }
+
+    count = graph->nodeCount;
+    while (level->nodeCount > 0) {
+        count = moveLouvainNodes(level, levelCommunity);
+        //Every node of graph follows its node to the community of this level
+        for (i = 0; i < graph->nodeCount; i++) {
+            community[i] = levelCommunity[community[i]];
+        }
+        if (count == level->nodeCount) {
+            break;
+        }
+        next = aggregateLouvainGraph(level, levelCommunity, count);
+        freeLouvainGraph(level);
+        level = next;
+    }
+    freeLouvainGraph(level);
+
+    //Renumber communities in the order of their first node, like calculateCommunityNumber
+    for (i = 0; i < count; i++) {
+        levelCommunity[i] = -1;
+    }
+    count = 0;
+    for (i = 0; i < graph->nodeCount; i++) {
+        if (levelCommunity[community[i]] == -1) {
+            levelCommunity[community[i]] = count++;
+        }
+        community[i] = levelCommunity[community[i]];
+    }
+    free(levelCommunity);
+
+    struct Community* com = (struct Community*)malloc(sizeof(struct Community));
+    com->communityNumber = count;
+    com->visited = community;
+    com->communitySize = (int*)calloc(count + 1, sizeof(int));
+    for (i = 0; i < graph->nodeCount; i++) {
+        com->communitySize[community[i]]++;
+    }
+    com->isEnd = 0;
+    return com;
+}
+
+/*
+@brief writes the measurements of the Girvan-Newman iterations as JSON or CSV
+@param filename file to write
+@param csv 1 to write CSV, 0 to write JSON
+@param graphFile name of the graph file that is measured
+@param graph measured graph
+@param options settings of the betweenness calculation
+@param loadTime seconds spent reading the graph
+@param stats measurements of every iteration
+@param count number of iterations
+*/
+void writeStats(const char* filename, int csv, const char* graphFile, struct Graph* graph, struct BetweennessOptions* options,
+                double loadTime, struct IterationStats* stats, int count) {
+    FILE* file = fopen(filename, "w");
+    int i;
+    const char* c;
+    if (file == NULL) {
+        printf("Cannot write stats file %s\n", filename);
+        exit(1);
+    }
+    if (csv) {
+        fprintf(file, "iteration,betweenness_seconds,removal_seconds,component_seconds,searches,visited_edges,removed_edges,communities,modularity\n");
+        for (i = 0; i < count; i++) {
+            fprintf(file, "%d,%.6f,%.6f,%.6f,%d,%lld,%d,%d,%.6f\n", stats[i].iteration, stats[i].betweennessTime,
+                    stats[i].removalTime, stats[i].componentTime, stats[i].searchCount, stats[i].visitedEdges,
+                    stats[i].removedEdges, stats[i].communityNumber, stats[i].modularity);
+        }
+        fclose(file);
+        return;
+    }
+
+    fprintf(file, "{\n  \"graph\": \"");
+    for (c = graphFile; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\') {
+            fputc('\\', file);
+        }
+        fputc(*c, file);
+    }
+    fprintf(file, "\",\n  \"nodes\": %d,\n  \"edges\": %d,\n  \"weighted\": %s,\n", graph->nodeCount, graph->edgeCount,
+            graph->weights != NULL ? "true" : "false");
+    fprintf(file, "  \"threads\": %d,\n  \"samples\": %d,\n  \"epsilon\": %g,\n  \"load_seconds\": %.6f,\n  \"iterations\": [",
+            options->threadCount, options->sampleCount, options->epsilon, loadTime);
+    for (i = 0; i < count; i++) {
+        fprintf(file, "%s\n    {\"iteration\": %d, \"betweenness_seconds\": %.6f, \"removal_seconds\": %.6f, "
+                "\"component_seconds\": %.6f, \"searches\": %d, \"visited_edges\": %lld, \"removed_edges\": %d, "
+                "\"communities\": %d, \"modularity\": %.6f}", i > 0 ? "," : "", stats[i].iteration,
+                stats[i].betweennessTime, stats[i].removalTime, stats[i].componentTime, stats[i].searchCount,
+                stats[i].visitedEdges, stats[i].removedEdges, stats[i].communityNumber, stats[i].modularity);
+    }
+    fprintf(file, "\n  ]\n}\n");
+    fclose(file);
+}
+
+/*
+@brief generates a uniform random number
+@param state state of generator
+@return random number in (0, 1]
+*/
+double nextUniform(uint64_t* state) {
+    return ((nextRandom(state) >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+
+/*
+@brief writes every pair of nodes in [first, first+count) as an edge with probability p. Pairs that are not written
+        are skipped with geometric jumps (Batagelj and Brandes), so the time is linear in the number of edges
+@param file edge list file
+@param first first node
+@param count number of nodes
+@param p edge probability
+@param blockSize if it is not 0 only pairs in different blocks of this size are written
+@param state state of random generator
+@return number of written edges
+*/
+long long writeRandomEdges(FILE* file, int first, int count, double p, int blockSize, uint64_t* state) {
+    long long v = 1, w = -1, written = 0;
+    double logP;
+    if (p <= 0 || count < 2) {
+        return 0;
+    }
+    logP = p < 1 ? log(1 - p) : 0;
+    while (v < count) {
+        //Number of pairs skipped before the next edge is geometric, (v, w) walks the pairs w < v in order
+        w += 1 + (p < 1 ? (long long)fmin(floor(log(nextUniform(state)) / logP), (double)count * count) : 0);
+        while (w >= v && v < count) {
+            w -= v;
+            v++;
+        }
+        if (v < count && (blockSize == 0 || (first + v) / blockSize != (first + w) / blockSize)) {
+            fprintf(file, "%lld %lld\n", first + v, first + w);
+            written++;
+        }
+    }
+    return written;
+}
+
+/*
+@brief writes a power-law graph with the Chung-Lu model: node i has expected degree proportional to
+        (i+1)^(-1/(exponent-1)) and the edge (u, v) exists with probability min(1, w_u*w_v/sum of w). Weights are
+        decreasing, so the probabilities in a row are decreasing and the pairs are skipped geometrically
+        (Miller and Hagberg)
+@param file edge list file
+@param nodeCount number of nodes
+@param degree average degree
+@param exponent exponent of the degree distribution, larger than 2
+@param state state of random generator
+@return number of written edges
+*/
+long long writePowerLawEdges(FILE* file, int nodeCount, double degree, double exponent, uint64_t* state) {
+    double* weights = (double*)malloc(sizeof(double) * (nodeCount + 1));
+    double sum = 0, p, q;
+    long long written = 0;
+    int u, v;
+    for (u = 0; u < nodeCount; u++) {
+        weights[u] = pow(u + 1, -1 / (exponent - 1));
+        sum += weights[u];
+    }
+    for (u = 0; u < nodeCount; u++) {
+        weights[u] *= degree * nodeCount / sum;
+    }
+    sum = degree * nodeCount;
+    for (u = 0; u < nodeCount - 1; u++) {
+        v = u + 1;
+        p = fmin(weights[u] * weights[v] / sum, 1);
+        while (v < nodeCount && p > 0) {
+            if (p < 1) {
+                v += (int)fmin(floor(log(nextUniform(state)) / log(1 - p)), nodeCount);
+            }
+            if (v < nodeCount) {
+                //Keep the candidate with the ratio of its own probability to the probability used for the jump
+                q = fmin(weights[u] * weights[v] / sum, 1);
+                if (nextUniform(state) <= q / p) {
+                    fprintf(file, "%d %d\n", u, v);
+                    written++;
+                }
+                p = q;
+                v++;
+            }
+        }
+    }
+    free(weights);
+    return written;
+}
+
+/*
+@brief writes a synthetic graph as an edge list, nodes are named 0 ... nodeCount-1 and nodes without edges are
+        not written. Models are Erdos-Renyi (er), stochastic block model with equal blocks (sbm) and power-law
+        degrees (powerlaw)
+@param filename file to write
+@param model er, sbm or powerlaw
+@param nodeCount number of nodes
+@param degree average degree
+@param blockCount number of blocks of sbm
+@param mixing fraction of the edges of a node that go to other blocks in sbm
+@param exponent exponent of the degree distribution of powerlaw
+@param state state of random generator
+*/
+void generateGraph(const char* filename, const char* model, int nodeCount, double degree, int blockCount, double mixing,
+                   double exponent, uint64_t* state) {
+    FILE* file = fopen(filename, "w");
+    long long written = 0;
+    int first, blockSize;
+    if (file == NULL) {
+        printf("Cannot write graph file %s\n", filename);
+        exit(1);
+    }
+    fprintf(file, "# %s nodes=%d degree=%g", model, nodeCount, degree);
+    if (strcmp(model, "er") == 0) {
+        fprintf(file, "\n");
+        written = writeRandomEdges(file, 0, nodeCount, degree / (nodeCount - 1), 0, state);
+    } else if (strcmp(model, "sbm") == 0) {
+        fprintf(file, " blocks=%d mixing=%g\n", blockCount, mixing);
+        blockSize = (nodeCount + blockCount - 1) / blockCount;
+        for (first = 0; first < nodeCount; first += blockSize) {
+            written += writeRandomEdges(file, first, nodeCount - first < blockSize ? nodeCount - first : blockSize,
+                                        degree * (1 - mixing) / (blockSize - 1), 0, state);
+        }
+        if (blockSize < nodeCount) {
+            written += writeRandomEdges(file, 0, nodeCount, degree * mixing / (nodeCount - blockSize), blockSize, state);
+        }
+    } else if (strcmp(model, "powerlaw") == 0) {
+        fprintf(file, " exponent=%g\n", exponent);
+        written = writePowerLawEdges(file, nodeCount, degree, exponent, state);
+    } else {
+        printf("Unknown model %s, use er, sbm or powerlaw\n", model);
+        exit(1);
+    }
+    fclose(file);
+    printf("Wrote %lld edges to %s\n", written, filename);
+}
+
+int main(int argc, char* argv[]) {
+    struct Graph graph;
+    struct BetweennessOptions options = {1, 0, 0, 0.1, 88172645463325252ULL, 0, 0};
+    const char* filename = "input.txt";
+    const char* snapshotFile = NULL;//Snapshot of the graph that is read, set with -s
+    const char* checkpointFile = NULL;//Snapshot written after every iteration, set with -c
+    struct Checkpoint checkpoint = {1, 1};
+    int useLouvain = 0;//Community detection algorithm, set with -a
+    const char* statsFile = NULL;//Measurements of every iteration are written to it, set with --stats
+    int statsCsv = 0;
+    const char* model = NULL;//Model of the generated graph, set with --generate
+    int generatedNodeCount = 1000;
+    double generatedDegree = 8;
+    int blockCount = 4;
+    double mixing = 0.1;
+    double exponent = 2.5;
+
+    int i,kValue = -1,tValue = -1;
+    for(i=1;i<argc;i++){
+        if((strcmp(argv[i],"-j") == 0 || strcmp(argv[i],"--threads") == 0) && i+1 < argc){
+            options.threadCount = atoi(argv[++i]);
+        }else if(strcmp(argv[i],"-k") == 0 && i+1 < argc){
+            kValue = atoi(argv[++i]);
+        }else if(strcmp(argv[i],"-t") == 0 && i+1 < argc){
+            tValue = atoi(argv[++i]);
+        }else if((strcmp(argv[i],"-m") == 0 || strcmp(argv[i],"--top-m") == 0) && i+1 < argc){
+            options.topCount = atoi(argv[++i]);
+        }else if(strcmp(argv[i],"-q") == 0 || strcmp(argv[i],"--quiet") == 0){
+            options.quiet = 1;
+        }else if(strcmp(argv[i],"--stats") == 0 && i+1 < argc){
+            statsFile = argv[++i];
+        }else if(strcmp(argv[i],"--stats-format") == 0 && i+1 < argc){
+            i++;
+            if(strcmp(argv[i],"csv") == 0){
+                statsCsv = 1;
+            }else if(strcmp(argv[i],"json") == 0){
+                statsCsv = 0;
+            }else{
+                printf("Unknown stats format %s, use json or csv\n",argv[i]);
+                return 1;
+            }
+        }else if(strcmp(argv[i],"--generate") == 0 && i+1 < argc){
+            model = argv[++i];
+        }else if(strcmp(argv[i],"--nodes") == 0 && i+1 < argc){
+            generatedNodeCount = atoi(argv[++i]);
+        }else if(strcmp(argv[i],"--degree") == 0 && i+1 < argc){
+            generatedDegree = atof(argv[++i]);
+        }else if(strcmp(argv[i],"--blocks") == 0 && i+1 < argc){
+            blockCount = atoi(argv[++i]);
+        }else if(strcmp(argv[i],"--mixing") == 0 && i+1 < argc){
+            mixing = atof(argv[++i]);
+        }else if(strcmp(argv[i],"--exponent") == 0 && i+1 < argc){
+            exponent = atof(argv[++i]);
+        }else if(strcmp(argv[i],"--samples") == 0 && i+1 < argc){
+            options.sampleCount = atoi(argv[++i]);
+        }else if(strcmp(argv[i],"--epsilon") == 0 && i+1 < argc){
+            options.epsilon = atof(argv[++i]);
+        }else if(strcmp(argv[i],"--delta") == 0 && i+1 < argc){
+            options.delta = atof(argv[++i]);
+        }else if(strcmp(argv[i],"--seed") == 0 && i+1 < argc){
+            options.randomState = strtoull(argv[++i], NULL, 10);
+        }else if((strcmp(argv[i],"-s") == 0 || strcmp(argv[i],"--snapshot") == 0) && i+1 < argc){
+            snapshotFile = argv[++i];
+        }else if((strcmp(argv[i],"-c") == 0 || strcmp(argv[i],"--checkpoint") == 0) && i+1 < argc){
+            checkpointFile = argv[++i];
+        }else if((strcmp(argv[i],"-a") == 0 || strcmp(argv[i],"--algorithm") == 0) && i+1 < argc){
+            i++;
+            if(strcmp(argv[i],"louvain") == 0){
+                useLouvain = 1;
+            }else if(strcmp(argv[i],"girvan-newman") == 0){
+                useLouvain = 0;
+            }else{
+                printf("Unknown algorithm %s, use louvain or girvan-newman\n",argv[i]);
+                return 1;
+            }
+        }else if(argv[i][0] != '-'){
+            filename = argv[i];
+        }else{
+            printf("Usage: %s [options] [graph file or snapshot]\n",argv[0]);
+            printf("  -a girvan-newman|louvain  community detection algorithm\n");
+            printf("  -j threads                threads used for edge betweenness\n");
+            printf("  -k k -t t                 stop values, they are asked if they are not given\n");
+            printf("  -m m                      remove the m edges with the highest betweenness in every iteration\n");
+            printf("  -q                        do not print paths, betweenness values, graphs and communities\n");
+            printf("  --stats file              write timings and search counts of every iteration\n");
+            printf("  --stats-format json|csv   format of the stats file, json by default\n");
+            printf("  -s file                   write a snapshot of the graph\n");
+            printf("  -c file                   write a checkpoint after every iteration\n");
+            printf("  --samples k               estimate betweenness from k random sources\n");
+            printf("  --epsilon e --delta d     choose the sample size for error e with probability 1-d\n");
+            printf("  --seed s                  seed of the source sampling and the generator\n");
+            printf("  --generate er|sbm|powerlaw write a synthetic edge list to the graph file and exit\n");
+            printf("  --nodes n --degree d      size and average degree of the generated graph\n");
+            printf("  --blocks b --mixing m     blocks of sbm and fraction of edges between blocks\n");
+            printf("  --exponent g              exponent of the powerlaw degree distribution\n");
+            return 1;
+        }
+    }
+    if(options.threadCount < 1){
+        options.threadCount = 1;
+    }
+    if(options.topCount < 0){
+        options.topCount = 0;
+    }
+    if(options.delta <= 0 || options.delta >= 1){
+        options.delta = 0.1;
+    }
+    if(options.randomState == 0){
+        options.randomState = 1;
+    }
+    if(model != NULL){
+        if(generatedNodeCount < 2 || generatedDegree <= 0 || blockCount < 1 || blockCount > generatedNodeCount ||
+           mixing < 0 || mixing > 1 || exponent <= 2){
+            printf("Invalid generator settings, nodes >= 2, degree > 0, 1 <= blocks <= nodes, 0 <= mixing <= 1 and exponent > 2\n");
+            return 1;
+        }
+        generateGraph(filename, model, generatedNodeCount, generatedDegree, blockCount, mixing, exponent, &options.randomState);
+        return 0;
+    }
+
+    double startTime = getTime();
+    if(isSnapshot(filename)){
+        //A checkpoint continues from the iteration it was written after
+        readSnapshot(&graph, filename, &checkpoint);
+    }else{
+        readGraph(&graph, filename);
+    }
+    if(snapshotFile != NULL){
+        writeSnapshot(&graph, snapshotFile, &checkpoint);
+    }
+    double loadTime = getTime() - startTime;
+    if(!options.quiet){
+        printGraph(&graph);
+    }
+
+    struct Community* com = NULL;
+    if(useLouvain){
+        com = findLouvainCommunities(&graph);
+        if(options.quiet){
+            printf("Communities: %d\n",com->communityNumber);
+        }else{
+            printCommunities(&graph,com);
+        }
+        printf("Modularity: %.4f\n",calculateModularity(&graph,com));
+        freeGraph(&graph);
+        freeCommunity(com);
+        return 0;
+    }
+
+    if(kValue == -1){
+        printf("\nEnter k value: ");
+        if(scanf("%d",&kValue) != 1){
+            printf("Invalid k value\n");
+            return 1;
+        }
+    }
+    if(tValue == -1){
+        printf("Enter t value: ");
+        if(scanf("%d",&tValue) != 1){
+            printf("Invalid t value\n");
+            return 1;
+        }
+    }
+    printf("\n");
+
+    int lastCommunityNumber = 0;
+    int repeatedCommunityNumberCounter = checkpoint.repeatedCommunityNumberCounter;
+    int flag = 0;
+    //Calculate community number of given graph
+    com = calculateCommunityNumber(&graph,tValue);
+    if(com->isEnd == 1){
+        flag = 1;
+        printf("\nProgram terminated due to t value!\n");
+    }
+    lastCommunityNumber = com->communityNumber;
+    int iteration = checkpoint.iteration;
+    struct BetweennessCache* cache = createBetweennessCache(&graph);
+    int statsCount = 0;
+    int statsCapacity = 16;
+    struct IterationStats* stats = (struct IterationStats*)malloc(sizeof(struct IterationStats) * statsCapacity);
+    struct IterationStats* current;
+    startTime = getTime();
+
+    while(flag == 0){
+        if(statsCount == statsCapacity){
+            statsCapacity *= 2;
+            stats = (struct IterationStats*)realloc(stats, sizeof(struct IterationStats) * statsCapacity);
+        }
+        current = &stats[statsCount++];
+        current->iteration = iteration;
+        if(!options.quiet){
+            printf("\n------------------------------ ITERATION %d ------------------------------\n",iteration);
+        }
+        findShortestPathAndCalculateEdgeBetweenness(&graph,cache,com,&options,current);
+        current->componentTime = getTime();
+        freeCommunity(com);
+        com = calculateCommunityNumber(&graph,tValue);
+        updateBetweennessCache(cache,com);
+        current->componentTime = getTime() - current->componentTime;
+        current->communityNumber = com->communityNumber;
+        current->modularity = calculateModularity(&graph,com);
+        if(com->isEnd == 1){
+            flag = 1;
+            printf("\nProgram terminated due to t value!\n");
+        }
+        if(com->communityNumber == lastCommunityNumber){
+            //If the number of communities is same previous one
+            repeatedCommunityNumberCounter++;
+        }else{
+            //If it's not the same as before reset counter
+            repeatedCommunityNumberCounter = 1;
+        }
+        if(repeatedCommunityNumberCounter == kValue){
+            //If the number of communities is same k times than stop the algorithm
+            flag = 1;
+            printf("\nProgram terminated due to k value!\n");
+        }
+        lastCommunityNumber = com->communityNumber;
+
+        //Print number of communities, community nodes and modularity of the partition
+        if(!options.quiet){
+            printCommunities(&graph,com);
+            printf("Modularity: %.4f\n",current->modularity);
+            printf("\n");
+        }
+        iteration++;
+        if(checkpointFile != NULL){
+            checkpoint.iteration = iteration;
+            checkpoint.repeatedCommunityNumberCounter = repeatedCommunityNumberCounter;
+            writeSnapshot(&graph, checkpointFile, &checkpoint);
+        }
+    }
+
+
+    if(options.quiet){
+        printf("Iterations: %d, communities: %d, modularity: %.4f, time: %.3f s\n",
+            statsCount, com->communityNumber, calculateModularity(&graph,com), getTime() - startTime);
+    }
+    if(statsFile != NULL){
+        writeStats(statsFile, statsCsv, filename, &graph, &options, loadTime, stats, statsCount);
+    }
+
+    // Belleği serbest bırak
+    free(stats);
+    freeGraph(&graph);
+    freeBetweennessCache(cache);
+    freeCommunity(com);
 
     return 0;
 }
@@ -2,43 +2,645 @@
 #include <string.h>
 #include <stdlib.h>
 #include <math.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#define GROUP_SIZE 16//Number of slots in a control group of the Swiss Table
+#define CONTROL_EMPTY ((int8_t)-128)//Control byte of a slot that has never been used
+#define CONTROL_DELETED ((int8_t)-2)//Control byte of a slot whose name was removed
+
+#define HASH_LONG_KEY 128//Keys longer than this are hashed 32 bytes at a time with SSE2
+#define HASH_SECRET0 0xa0761d6478bd642fULL
+#define HASH_SECRET1 0xe7037ed1a0b428dbULL
+#define HASH_SECRET2 0x8ebc6af09c88c6e3ULL
+#define HASH_SECRET3 0x589965cc75374cc3ULL
+
+#define INLINE_NAME 16//Names shorter than this are stored in their slot, longer names in the key arena
+#define CHUNK_SIZE 65536//Minimum size of a chunk of the key arena
+#define EMPTY_SLOT -1//Length of a slot that has never been used
+#define MOVED_SLOT -2//Length of an old double hashing slot whose name was moved to the new table while resizing
+
+#define DEFAULT_LOAD_FACTOR 0.75//Used when the given load factor is not between 0 and 1
+#define MIGRATION_STEP 8//Number of old slots moved to the new table in every operation while the table is resized
+#define PREFETCH_DISTANCE 8//Batch operations prefetch the slots of the name this many positions ahead
+
+#define ENGINE_DOUBLE 1//Double hashing on HASH_ITEM slots
+#define ENGINE_SWISS 2//Swiss Table with 16-slot control groups
+#define ENGINE_CONCURRENT 3//Linear probing with lock-free searches and striped locks for writers
+#define ENGINE_ROBIN 4//Robin Hood linear probing with backward-shift deletion
+#define ENGINE_PERSISTENT 5//Linear probing in a memory-mapped file with a write-ahead log
+#define HISTOGRAM_SIZE 16//Probe lengths from HISTOGRAM_SIZE on are counted together
+#define STATS_SAMPLES 10000//Number of names that are not in the table whose searches give the unsuccessful probe lengths
+
+#define STRIPE_COUNT 64//Number of writer locks of the concurrent table, a name is guarded by the lock its hash selects
+#define MAX_THREADS 64//Maximum number of threads that use a concurrent table
+#define RETIRE_LIMIT 64//A thread tries to advance the epoch when it has this many blocks waiting to be freed
+#define REARRANGE_CUTOFF 65536//Minimum number of slots of every thread of a parallel rearrange
+#define BENCHMARK_OPERATIONS 500000//Operations of every thread in the scaling benchmark
+#define BENCHMARK_READS 100//Searches per insertion or removal in the scaling benchmark
+#define BENCHMARK_NAME 32//Space of a name of the workload benchmark
+#define WORKLOAD_UNIFORM 1//Every name is used equally often
+#define WORKLOAD_ZIPF 2//Name popularity follows Zipf's law with ZIPF_EXPONENT
+#define WORKLOAD_CHURN 3//Mostly insertions and removals
+#define ZIPF_EXPONENT 0.99
+
+#define PERSISTENT_MAGIC "HASHDB01"//First bytes of a persistent table file
+#define WAL_MAGIC 0x314C4157U//First bytes of a record of the write-ahead log ("WAL1")
+#define WAL_LIMIT (4 << 20)//The log is written to the table file when it is longer than this
+#define CHECKPOINT_PAGE 4096//Unit in which a checkpoint writes the changed parts of the table file
 
 /*
-@brief Struct for Hash Table items
+@brief Struct for Hash Table items. Short names are stored in the slot itself, so they need no allocation and are compared
+       without following a pointer, longer names are stored in the key arena of their table
 */
 typedef struct HASH_ITEM{
-    char* username;
+    uint64_t hash;//Hash value of the name, it is kept so that rearrange does not calculate it again
+    int length;//Length of the name, EMPTY_SLOT or MOVED_SLOT if the slot has no name
     int isDeleted;
+    union{
+        char* stored;//Name in the key arena if it has INLINE_NAME or more characters
+        char inlined[INLINE_NAME];//Name and its terminating zero if it is shorter
+    }name;
 }HASH_ITEM;
 
 /*
-@brief Finds the numerical value of a given name using Horner's rule
-@param username The name whose numerical value will be calculated
-@return Numerical value of the given name
+@brief Chunk of the key arena, names are allocated from its end one after another
+*/
+typedef struct ARENA_CHUNK{
+    struct ARENA_CHUNK* next;
+    size_t size;//Number of bytes in data
+    size_t used;//Number of allocated bytes
+    char data[];
+}ARENA_CHUNK;
+
+/*
+@brief Bump allocator for the long names of a Hash Table. Names are never freed one by one, the bytes of dropped names are counted
+       and given back when the live names are copied to a new arena
+*/
+typedef struct KEY_ARENA{
+    ARENA_CHUNK* chunks;//Newest chunk first, names are allocated from it
+    size_t live;//Bytes of the names that are in a table
+    size_t garbage;//Bytes of the names that were dropped
+}KEY_ARENA;
+
+/*
+@brief Type of the functions that calculate the 64-bit hash value of a key
+*/
+typedef uint64_t (*HASH_FUNCTION)(const char* key, size_t length);
+
+/*
+@brief Struct for Swiss Table. Every slot has a control byte that is EMPTY, DELETED or the low 7 bits of the hash of its name (H2).
+       Control bytes of 16 slots form a group that is compared with H2 at once, so the names are only compared when the fingerprints match
+*/
+typedef struct SWISS_TABLE{
+    int8_t* control;//Control bytes of all slots
+    HASH_ITEM* slots;
+    int groupCount;//Number of groups, a power of 2
+    int counter;//Number of names in the table
+    int deleted;//Number of DELETED slots
+    KEY_ARENA* arena;//Storage of the long names, it is shared with the other table while resizing
+}SWISS_TABLE;
+
+/*
+@brief Struct for Robin Hood Table. Names are probed linearly and a name that is further from its home slot takes the slot of a name that
+       is closer to its own, so the probe lengths of all names stay close to each other. Removed names are filled by shifting the
+       following names one slot back, so the table has no tombstones
+*/
+typedef struct ROBIN_TABLE{
+    HASH_ITEM* slots;
+    int size;//Number of slots, a power of 2
+    int counter;//Number of names in the table
+    KEY_ARENA* arena;//Storage of the long names, it is shared with the other table while resizing
+}ROBIN_TABLE;
+
+/*
+@brief Header at the beginning of a persistent table file, it is followed by the slots and the key area
+*/
+typedef struct PERSISTENT_HEADER{
+    char magic[8];//PERSISTENT_MAGIC
+    uint32_t hashFunction;//1 = calculateFastHash, 2 = calculateFnvHash, the stored hash values are only valid with it
+    uint32_t reserved;
+    uint64_t slotCount;//Number of slots, a power of 2
+    uint64_t counter;//Number of names that have not been deleted
+    uint64_t used;//Number of slots that have a name or a tombstone
+    uint64_t keyBytes;//Number of used bytes of the key area
+    uint64_t keyCapacity;//Size of the key area
+    uint64_t padding;
+}PERSISTENT_HEADER;
+
+/*
+@brief Slot of a persistent table. It has the layout of HASH_ITEM, but a long name is referenced by its offset in the key area, so the
+       file is valid wherever it is mapped
+*/
+typedef struct PERSISTENT_SLOT{
+    uint64_t hash;
+    int32_t length;//Length of the name, EMPTY_SLOT if the slot has never been used
+    int32_t isDeleted;
+    union{
+        uint64_t offset;//Offset of the name in the key area if it has INLINE_NAME or more characters
+        char inlined[INLINE_NAME];//Name and its terminating zero if it is shorter
+    }name;
+}PERSISTENT_SLOT;
+
+/*
+@brief Struct for a persistent table. The file is mapped privately, so changes in memory never reach the file by themselves: every
+       change is first appended to the write-ahead log with the bytes it writes, and the logged bytes are copied to the file when the
+       log is checkpointed. A crash can only lose the changes that were not committed to the log, the file is never half written
+*/
+typedef struct PERSISTENT_TABLE{
+    char* path;
+    int fd;
+    int walFd;
+    char* map;//Private mapping of the file
+    size_t mapSize;
+    PERSISTENT_HEADER* header;
+    PERSISTENT_SLOT* slots;
+    char* keys;//Key area
+    char* wal;//Records of the log since the last checkpoint
+    size_t walSize;
+    size_t walCapacity;
+    size_t walCommitted;//Bytes of wal that were written to the log file
+    size_t recordStart;//Start of the record that is being built, it equals walSize when there is no record
+    float loadFactor;//Maximum ratio of used slots
+    int isNew;//1 if the file was created when the table was opened
+}PERSISTENT_TABLE;
+
+/*
+@brief Name stored in the concurrent table. It is never changed after it is published to a slot, so searches can read it without a lock
+*/
+typedef struct CONCURRENT_NAME{
+    uint64_t hash;
+    int length;
+    char username[];
+}CONCURRENT_NAME;
+
+/*
+@brief Slot array of the concurrent table. Slots only change from empty to a name and between a name and a tombstone, they never become
+       empty again, so a search that reaches an empty slot knows that the name is not in the table. Tombstones are dropped by building
+       a new slot array
+*/
+typedef struct CONCURRENT_SLOTS{
+    _Atomic(CONCURRENT_NAME*)* names;
+    int size;//Number of slots, a power of 2
+    atomic_int used;//Number of slots that have a name or a tombstone and of empty slots that are reserved by insertions
+}CONCURRENT_SLOTS;
+
+/*
+@brief Memory block that was removed from the concurrent table and is freed when no thread can read it anymore
+*/
+typedef struct RETIRED_BLOCK{
+    void* block;
+    void (*release)(void* block);
+    struct RETIRED_BLOCK* next;
+}RETIRED_BLOCK;
+
+/*
+@brief Epoch state of a thread that uses the concurrent table. It is aligned to a cache line so that threads do not share lines
+*/
+typedef struct EPOCH_THREAD{
+    _Alignas(64) atomic_ulong epoch;//Global epoch when the thread started its current operation
+    atomic_int active;//1 while the thread is in an operation
+    unsigned long lastEpoch;//Epoch of the previous operation of the thread
+    RETIRED_BLOCK* retired[3];//Blocks retired in epochs with the same remainder modulo 3
+    int retiredCount;
+}EPOCH_THREAD;
+
+/*
+@brief Struct for the concurrent table. Searches only read atomic slot pointers. Insertions and removals lock the stripe of their name,
+       so two writers of the same name are ordered, and claim slots with compare-and-swap, so writers of different names can share
+       a probe sequence. Removed names and replaced slot arrays are freed with epoch-based reclamation: a block retired in epoch e
+       is freed after the global epoch passes e + 2, which is only possible after every thread that could have read it finished
+*/
+typedef struct CONCURRENT_TABLE{
+    _Atomic(CONCURRENT_SLOTS*) slots;
+    pthread_mutex_t locks[STRIPE_COUNT];
+    atomic_int counter;//Number of names in the table
+    float loadFactor;//Maximum ratio of used slots
+    atomic_ulong epoch;//Global epoch
+    EPOCH_THREAD threads[MAX_THREADS];
+}CONCURRENT_TABLE;
+
+/*
+@brief Struct for a Hash Table of any engine, only the fields of its engine are used.
+       When the used slots exceed the load factor a new table is created and the slots of the old table are moved to it
+       MIGRATION_STEP at a time in the following operations, so no operation rehashes the whole table
+*/
+typedef struct HASH_TABLE{
+    int engine;//ENGINE_DOUBLE, ENGINE_SWISS, ENGINE_CONCURRENT, ENGINE_ROBIN or ENGINE_PERSISTENT
+    KEY_ARENA* arena;//Storage of the long names of the double hashing and Swiss tables
+    HASH_ITEM* hashTable;//Slots of double hashing
+    int M;//Size of the double hashing table, a prime
+    int counter;//Number of names in the double hashing tables that have not been deleted
+    int used;//Number of slots of hashTable that have a name or a tombstone
+    SWISS_TABLE* swiss;
+    CONCURRENT_TABLE* concurrent;//Concurrent table, it resizes itself
+    ROBIN_TABLE* robin;
+    PERSISTENT_TABLE* persistent;//Persistent table, it is opened with openPersistentTable
+    float loadFactor;//Maximum ratio of used slots
+    HASH_ITEM* oldHashTable;//Double hashing table that is being moved, NULL if the table is not resized
+    int oldM;
+    SWISS_TABLE* oldSwiss;//Swiss Table that is being moved, NULL if the table is not resized
+    ROBIN_TABLE* oldRobin;//Robin Hood Table that is being moved, NULL if the table is not resized
+    int migrated;//Number of slots of the old table that were moved
+}HASH_TABLE;
+
+/*
+@brief Statistics of a Hash Table, they are collected without printing
+*/
+typedef struct TABLE_STATS{
+    long long names;//Number of names in the table
+    long long tombstones;//Number of slots of removed names that still lengthen probes
+    long long slots;//Number of slots
+    double loadFactor;//Ratio of slots that have a name or a tombstone
+    double tombstoneRatio;//Ratio of slots that have a tombstone
+    double meanHit;//Mean probe length of successful searches
+    double deviationHit;//Standard deviation of the probe lengths of successful searches
+    int maxHit;
+    double meanMiss;//Mean probe length of unsuccessful searches
+    int maxMiss;
+    long long hits[HISTOGRAM_SIZE];//Number of names for every probe length, the last one counts longer probes too
+    long long misses[HISTOGRAM_SIZE];//Number of unsuccessful sample searches for every probe length
+}TABLE_STATS;
+
+CONCURRENT_NAME removedName;//Tombstone of the concurrent table, slots point to it when their names are removed
+
+/*
+@brief Multiplies two 64-bit numbers and folds the 128-bit product into 64 bits
+@param a First number
+@param b Second number
+@return Low half of the product xor its high half
+*/
+uint64_t mixHash(uint64_t a, uint64_t b){
+    __uint128_t product = (__uint128_t)a * b;
+    return (uint64_t)product ^ (uint64_t)(product >> 64);
+}
+
+/*
+@brief Reads 8 bytes of a key as a little endian number
+@param p First byte
+@return Read number
+*/
+uint64_t readWord(const char* p){
+    uint64_t value;
+    memcpy(&value,p,sizeof(value));
+    return value;
+}
+
+/*
+@brief Reads 4 bytes of a key as a little endian number
+@param p First byte
+@return Read number
+*/
+uint64_t readHalfWord(const char* p){
+    uint32_t value;
+    memcpy(&value,p,sizeof(value));
+    return value;
+}
+
+/*
+@brief Accumulates the 32-byte stripes of a long key into 4 lanes. Every 64-bit word is xored with a secret that changes with its position,
+       then the product of its two 32-bit halves and the word itself are added to its lane. Lanes are scrambled every 16 stripes.
+       SSE2 processes two lanes in one instruction, the scalar loop calculates the same values
+@param key Key to be hashed
+@param stripeCount Number of stripes
+@param lanes 4 accumulators, they are updated
+@return
+*/
+void accumulateStripes(const char* key, size_t stripeCount, uint64_t* lanes){
+    size_t i;
+#ifdef __SSE2__
+    __m128i lanes01 = _mm_loadu_si128((const __m128i*)lanes);
+    __m128i lanes23 = _mm_loadu_si128((const __m128i*)(lanes + 2));
+    __m128i secret01 = _mm_set_epi64x((long long)HASH_SECRET1,(long long)HASH_SECRET0);
+    __m128i secret23 = _mm_set_epi64x((long long)HASH_SECRET3,(long long)HASH_SECRET2);
+    __m128i step = _mm_set1_epi64x((long long)HASH_SECRET1);
+    __m128i prime = _mm_set1_epi32((int)0x9E3779B1U);
+    __m128i data, word;
+    for(i=0;i<stripeCount;i++){
+        data = _mm_loadu_si128((const __m128i*)(key + 32*i));
+        word = _mm_xor_si128(data,secret01);
+        lanes01 = _mm_add_epi64(lanes01,_mm_add_epi64(data,_mm_mul_epu32(word,_mm_srli_epi64(word,32))));
+        data = _mm_loadu_si128((const __m128i*)(key + 32*i + 16));
+        word = _mm_xor_si128(data,secret23);
+        lanes23 = _mm_add_epi64(lanes23,_mm_add_epi64(data,_mm_mul_epu32(word,_mm_srli_epi64(word,32))));
+        secret01 = _mm_add_epi64(secret01,step);
+        secret23 = _mm_add_epi64(secret23,step);
+        if(i % 16 == 15){
+            //lane = (lane ^ (lane >> 47)) * prime, the 64x32-bit product is built from two 32x32-bit products
+            lanes01 = _mm_xor_si128(lanes01,_mm_srli_epi64(lanes01,47));
+            lanes01 = _mm_add_epi64(_mm_mul_epu32(lanes01,prime),_mm_slli_epi64(_mm_mul_epu32(_mm_srli_epi64(lanes01,32),prime),32));
+            lanes23 = _mm_xor_si128(lanes23,_mm_srli_epi64(lanes23,47));
+            lanes23 = _mm_add_epi64(_mm_mul_epu32(lanes23,prime),_mm_slli_epi64(_mm_mul_epu32(_mm_srli_epi64(lanes23,32),prime),32));
+        }
+    }
+    _mm_storeu_si128((__m128i*)lanes,lanes01);
+    _mm_storeu_si128((__m128i*)(lanes + 2),lanes23);
+#else
+    uint64_t secret[4] = {HASH_SECRET0,HASH_SECRET1,HASH_SECRET2,HASH_SECRET3};
+    uint64_t data, word;
+    int lane;
+    for(i=0;i<stripeCount;i++){
+        for(lane=0;lane<4;lane++){
+            data = readWord(key + 32*i + 8*lane);
+            word = data ^ secret[lane];
+            lanes[lane] += data + (word & 0xFFFFFFFFULL) * (word >> 32);
+            secret[lane] += HASH_SECRET1;
+        }
+        if(i % 16 == 15){
+            for(lane=0;lane<4;lane++){
+                lanes[lane] = (lanes[lane] ^ (lanes[lane] >> 47)) * 0x9E3779B1ULL;
+            }
+        }
+    }
+#endif
+}
+
+/*
+@brief Finds the 64-bit hash value of a key with multiply-mix rounds in the style of wyhash. Short keys are read with at most 4 overlapping
+       loads, keys up to HASH_LONG_KEY bytes are mixed 48 bytes per round and longer keys are accumulated 32 bytes at a time with SSE2
+@param key Key to be hashed
+@param length Length of the key
+@return Hash value of the key
+*/
+uint64_t calculateFastHash(const char* key, size_t length){
+    const char* p = key;
+    uint64_t seed = mixHash(HASH_SECRET0,HASH_SECRET1);
+    uint64_t a, b, see1, see2;
+    uint64_t lanes[4] = {HASH_SECRET0,HASH_SECRET1,HASH_SECRET2,HASH_SECRET3};
+    __uint128_t product;
+    size_t i = length;
+    if(length <= 16){
+        if(length >= 4){
+            a = (readHalfWord(p) << 32) | readHalfWord(p + ((length >> 3) << 2));
+            b = (readHalfWord(p + length - 4) << 32) | readHalfWord(p + length - 4 - ((length >> 3) << 2));
+        }else if(length > 0){
+            a = ((uint64_t)(unsigned char)p[0] << 16) | ((uint64_t)(unsigned char)p[length >> 1] << 8) | (unsigned char)p[length - 1];
+            b = 0;
+        }else{
+            a = 0;
+            b = 0;
+        }
+    }else{
+        if(length > HASH_LONG_KEY){
+            //Every stripe is accumulated independently, the last 1 to 32 bytes are left to the loop below
+            size_t stripeCount = (length - 1) / 32;
+            accumulateStripes(p,stripeCount,lanes);
+            seed ^= mixHash(lanes[0] ^ HASH_SECRET1,lanes[1] ^ seed) ^ mixHash(lanes[2] ^ HASH_SECRET2,lanes[3] ^ HASH_SECRET3);
+            p += 32*stripeCount;
+            i -= 32*stripeCount;
+        }else if(i > 48){
+            see1 = seed;
+            see2 = seed;
+            do{
+                seed = mixHash(readWord(p) ^ HASH_SECRET1,readWord(p + 8) ^ seed);
+                see1 = mixHash(readWord(p + 16) ^ HASH_SECRET2,readWord(p + 24) ^ see1);
+                see2 = mixHash(readWord(p + 32) ^ HASH_SECRET3,readWord(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            }while(i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while(i > 16){
+            seed = mixHash(readWord(p) ^ HASH_SECRET1,readWord(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        //The last 16 bytes of the key, they can overlap with the bytes that are already mixed
+        a = readWord(p + i - 16);
+        b = readWord(p + i - 8);
+    }
+    product = (__uint128_t)(a ^ HASH_SECRET1) * (b ^ seed);
+    return mixHash((uint64_t)product ^ HASH_SECRET0 ^ length,(uint64_t)(product >> 64) ^ HASH_SECRET1);
+}
+
+/*
+@brief Finds the 64-bit hash value of a key with FNV-1a, the result is mixed so that both its low and high bits depend on every character
+@param key Key to be hashed
+@param length Length of the key
+@return Hash value of the key
+*/
+uint64_t calculateFnvHash(const char* key, size_t length){
+    uint64_t hash = 14695981039346656037ULL;
+    size_t i;
+    for(i=0;i<length;i++){
+        hash ^= (unsigned char)key[i];
+        hash *= 1099511628211ULL;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+HASH_FUNCTION hashName = calculateFastHash;//Hash function of all engines, set with -H
+
+/*
+@brief Creates an empty key arena, its first chunk is allocated with the first long name
+@return Created key arena
+*/
+KEY_ARENA* createArena(){
+    KEY_ARENA* arena = (KEY_ARENA*) malloc(sizeof(KEY_ARENA));
+    if(arena == NULL){
+        printf("Memory allocation error!");
+        exit(1);
+    }
+    arena->chunks = NULL;
+    arena->live = 0;
+    arena->garbage = 0;
+    return arena;
+}
+
+/*
+@brief Frees all chunks of the key arena, the arena itself is kept empty
+@param arena Key arena to be emptied
+@return
+*/
+void freeArenaChunks(KEY_ARENA* arena){
+    ARENA_CHUNK* next;
+    while(arena->chunks != NULL){
+        next = arena->chunks->next;
+        free(arena->chunks);
+        arena->chunks = next;
+    }
+    arena->live = 0;
+    arena->garbage = 0;
+}
+
+/*
+@brief Allocates bytes from the newest chunk of the key arena, a new chunk is added when it does not have enough space
+@param arena Key arena
+@param size Number of bytes
+@return Allocated bytes
+*/
+char* allocateInArena(KEY_ARENA* arena, size_t size){
+    ARENA_CHUNK* chunk = arena->chunks;
+    if(chunk == NULL || chunk->size - chunk->used < size){
+        size_t chunkSize = size > CHUNK_SIZE ? size : CHUNK_SIZE;
+        chunk = (ARENA_CHUNK*) malloc(sizeof(ARENA_CHUNK) + chunkSize);
+        if(chunk == NULL){
+            printf("Memory allocation error!");
+            exit(1);
+        }
+        chunk->next = arena->chunks;
+        chunk->size = chunkSize;
+        chunk->used = 0;
+        arena->chunks = chunk;
+    }
+    chunk->used += size;
+    arena->live += size;
+    return chunk->data + chunk->used - size;
+}
+
+/*
+@brief Finds the name of a slot
+@param item Slot of a Hash Table
+@return Name of the slot, NULL if it has no name
+*/
+char* itemName(HASH_ITEM* item){
+    if(item->length < 0){
+        return NULL;
+    }
+    return item->length < INLINE_NAME ? item->name.inlined : item->name.stored;
+}
+
+/*
+@brief Compares two names of the same length in blocks of 32 bytes with AVX2 and 16 bytes with SSE2. The bytes after the last whole block
+       are compared as the block that ends with the names, so no byte after the names is read
+@param a First name
+@param b Second name
+@param length Length of both names
+@return 1 if the names are equal, 0 otherwise
+*/
+int equalNames(const char* a, const char* b, int length){
+    int i = 0;
+#ifdef __AVX2__
+    for(;i + 32 <= length;i += 32){
+        __m256i x = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i y = _mm256_loadu_si256((const __m256i*)(b + i));
+        if((unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x,y)) != 0xFFFFFFFFU){
+            return 0;
+        }
+    }
+#endif
+#ifdef __SSE2__
+    for(;i + 16 <= length;i += 16){
+        __m128i x = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i y = _mm_loadu_si128((const __m128i*)(b + i));
+        if(_mm_movemask_epi8(_mm_cmpeq_epi8(x,y)) != 0xFFFF){
+            return 0;
+        }
+    }
+    if(i < length && length >= 16){
+        __m128i x = _mm_loadu_si128((const __m128i*)(a + length - 16));
+        __m128i y = _mm_loadu_si128((const __m128i*)(b + length - 16));
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(x,y)) == 0xFFFF;
+    }
+#endif
+    return memcmp(a + i,b + i,length - i) == 0;
+}
+
+/*
+@brief Checks whether a slot has the given name. The cached hash values and the lengths are compared before the characters, so names that
+       only share a long prefix are rejected without reading them
+@param item Slot of a Hash Table
+@param username Name to be compared
+@param length Length of the name
+@param hash Hash value of the name
+@return 1 if the slot has the name, 0 otherwise
 */
-int calculateKeyWithHorner(char* username){
-    int key = 0;
-    int R = 31;
-    int L = strlen(username);
+int isSameName(HASH_ITEM* item, char* username, int length, uint64_t hash){
+    return item->hash == hash && item->length == length && equalNames(itemName(item),username,length);
+}
+
+/*
+@brief Stores a name in a slot, in the slot itself if it is short and in the key arena otherwise
+@param item Slot whose name is set, its previous name must be dropped before
+@param arena Key arena of the table
+@param username Name to be stored
+@param length Length of the name
+@return
+*/
+void setItemName(HASH_ITEM* item, KEY_ARENA* arena, char* username, int length){
+    item->length = length;
+    if(item->length < INLINE_NAME){
+        memcpy(item->name.inlined,username,item->length + 1);
+    }else{
+        item->name.stored = allocateInArena(arena,item->length + 1);
+        memcpy(item->name.stored,username,item->length + 1);
+    }
+}
+
+/*
+@brief Drops the name of a slot, the bytes of a long name become garbage of the key arena until it is compacted
+@param item Slot whose name is dropped
+@param arena Key arena of the table
+@return
+*/
+void dropItemName(HASH_ITEM* item, KEY_ARENA* arena){
+    if(item->length >= INLINE_NAME){
+        arena->live -= item->length + 1;
+        arena->garbage += item->length + 1;
+    }
+}
+
+/*
+@brief Copies the long names of the given slots to a key arena, the slots point to the copies afterwards
+@param items Slots whose names are moved
+@param count Number of slots
+@param arena Key arena that receives the names
+@return
+*/
+void moveNamesToArena(HASH_ITEM* items, int count, KEY_ARENA* arena){
+    char* name;
     int i;
-    for(i=0;i<L;i++){
-        key += (int)username[i] * (int)pow(R,L-1-i);
+    for(i=0;i<count;i++){
+        if(items[i].length >= INLINE_NAME){
+            name = allocateInArena(arena,items[i].length + 1);
+            memcpy(name,items[i].name.stored,items[i].length + 1);
+            items[i].name.stored = name;
+        }
     }
-    return abs(key);
+}
+
+/*
+@brief Copies the long names of the given slots to new chunks and frees the old chunks, so the bytes of dropped names are given back.
+       All slots that use the arena must be given
+@param items Slots whose names are moved
+@param count Number of slots
+@param arena Key arena to be compacted
+@return
+*/
+void compactArena(HASH_ITEM* items, int count, KEY_ARENA* arena){
+    KEY_ARENA compacted = {NULL,0,0};
+    moveNamesToArena(items,count,&compacted);
+    freeArenaChunks(arena);
+    *arena = compacted;
 }
 
 /*
 @brief Converts a given numerical value into a hash index using double hashing and division methods
-@param key Numeric value to be converted to hash index
+@param key Hash value to be converted to hash index, the second hash function uses its high 32 bits
 @param i Value starting from 0 and increasing to get the next hash index of the key that can be placed
 @param M Size of the Hash Table
 @param mode Mode in which the program is run (1 = Normal Mode, 2 = Debug Mode)
 @return Calculated hash index of the key
 */
-int hashFunction(int key,int i,int M,int mode){
-    int h1 = key % M;//Result of first hash function
-    int h2 = 1 + (key % (M-2));//Result of second hash function
-    int hashIndex = (h1 + i*h2) % M;//Result of double hashing
+int hashFunction(uint64_t key,int i,int M,int mode){
+    int h1 = (int)(key % M);//Result of first hash function
+    int h2 = 1 + (int)((key >> 32) % (M-2));//Result of second hash function
+    int hashIndex = (int)((h1 + (long long)i*h2) % M);//Result of double hashing
     if(mode == 2){
         printf("H1 = %d -- H2 = %d -- i = %d -- HashIndex = %d\n",h1,h2,i,hashIndex);
     }
@@ -56,7 +658,7 @@ void printHashTable(HASH_ITEM* hashTable, int M){
     int i;
     for(i=0;i<M;i++){
         //if(hashTable[i].username != NULL){
-            printf("%d: %s (%d)\n",i,hashTable[i].username,hashTable[i].isDeleted);
+            printf("%d: %s (%d)\n",i,itemName(&hashTable[i]),hashTable[i].isDeleted);
         //}
     }
 }
@@ -72,7 +674,7 @@ void printTwoHashTable(HASH_ITEM* hashTable1, HASH_ITEM* hashTable2, int M){
     printf("\n");
     int i;
     for(i=0;i<M;i++){
-        printf("%d: %s (%d) || %d: %s (%d)\n",i,hashTable1[i].username,hashTable1[i].isDeleted,i,hashTable2[i].username,hashTable2[i].isDeleted);
+        printf("%d: %s (%d) || %d: %s (%d)\n",i,itemName(&hashTable1[i]),hashTable1[i].isDeleted,i,itemName(&hashTable2[i]),hashTable2[i].isDeleted);
     }
 }
 
@@ -88,11 +690,12 @@ void removeFromHashTable(HASH_ITEM* hashTable, int M, char* username, int mode,
     if(mode == 2){
         printf("\nRemoving %s\n",username);
     }
-    int key = calculateKeyWithHorner(username);
+    int length = (int)strlen(username);
+    uint64_t key = hashName(username,length);
     int hashIndex = hashFunction(key,0,M,mode);
     int i = 1;
-    while(hashTable[hashIndex].username != NULL){
-        if(strcmp(hashTable[hashIndex].username,username) == 0 && hashTable[hashIndex].isDeleted == 0){
+    while(hashTable[hashIndex].length != EMPTY_SLOT){
+        if(isSameName(&hashTable[hashIndex],username,length,key) && hashTable[hashIndex].isDeleted == 0){
             hashTable[hashIndex].isDeleted = 1;
             *counter = *counter - 1;
             if(mode == 2){
@@ -125,11 +728,12 @@ int searchInHashTable(HASH_ITEM* hashTable, int M, char* username,int mode){
         printf("\nSearching %s\n",username);
     }
 
-    int key = calculateKeyWithHorner(username);
+    int length = (int)strlen(username);
+    uint64_t key = hashName(username,length);
     int hashIndex = hashFunction(key,0,M,mode);
     int i = 1;
-    while(hashTable[hashIndex].username != NULL){
-        if(strcmp(hashTable[hashIndex].username,username) == 0 && hashTable[hashIndex].isDeleted == 0){
+    while(hashTable[hashIndex].length != EMPTY_SLOT){
+        if(isSameName(&hashTable[hashIndex],username,length,key) && hashTable[hashIndex].isDeleted == 0){
             if(mode == 2){
                 printf("%s was found in [%d] after %d attempts\n",username,hashIndex,i);
             }
@@ -149,14 +753,15 @@ int searchInHashTable(HASH_ITEM* hashTable, int M, char* username,int mode){
 @param hashTable Hash Table to be searched
 @param M Size of the Hash Table
 @param username Name to be searched
+@param length Length of the name
+@param key Hash value of the name
 @return Index of the name in the Hash Table (-1 = Not Found)
 */
-int searchInHashTableAll(HASH_ITEM* hashTable, int M, char* username){
-    int key = calculateKeyWithHorner(username);
+int searchInHashTableAll(HASH_ITEM* hashTable, int M, char* username, int length, uint64_t key){
     int hashIndex = hashFunction(key,0,M,1);
     int i = 1;
-    while(hashTable[hashIndex].username != NULL){
-        if(strcmp(hashTable[hashIndex].username,username) == 0){
+    while(hashTable[hashIndex].length != EMPTY_SLOT){
+        if(isSameName(&hashTable[hashIndex],username,length,key)){
             //If the name is in the table, its index is returned whether it is deleted or not.
             return hashIndex;
         }
@@ -172,21 +777,21 @@ int searchInHashTableAll(HASH_ITEM* hashTable, int M, char* username){
 @param M Size of the Hash Table
 @param username Name to be inserted
 @param mode Mode in which the program is run (1 = Normal Mode, 2 = Debug Mode)
+@param counter Number of names that have not been deleted, it is increased
+@param used Number of slots that have a name or a tombstone, it is increased if an empty slot is used
+@param arena Key arena of the table
 @return
 */
-void insertToHashTable(HASH_ITEM* hashTable, int M, char* username,int mode, int* counter, int N){
-	
-    if(*counter == N){
-        printf("Maximum number of elements reached!\n");
-        return;
-    }
+void insertToHashTable(HASH_ITEM* hashTable, int M, char* username,int mode, int* counter, int* used, KEY_ARENA* arena){
 
     if(mode == 2){
         printf("\nInserting %s\n",username);
     }
     
     //The search is performed before the name is inserted to the hash table
-    int hashIndex = searchInHashTableAll(hashTable,M,username);
+    int length = (int)strlen(username);
+    uint64_t key = hashName(username,length);
+    int hashIndex = searchInHashTableAll(hashTable,M,username,length,key);
     if (hashIndex != -1 && hashTable[hashIndex].isDeleted == 0){
         //If the name exists in the table and has not been deleted, it will not be inserted.
         printf("%s is already in the table!\n",username);
@@ -203,29 +808,24 @@ void insertToHashTable(HASH_ITEM* hashTable, int M, char* username,int mode, int
     }
 	
     //If the name does not exist in the table, it will be inserted to the first empty index.
-    int key = calculateKeyWithHorner(username);
     hashIndex = hashFunction(key,0,M,mode);
     int i = 1;
-    while(hashTable[hashIndex].username != NULL && hashTable[hashIndex].isDeleted == 0){
+    while(hashTable[hashIndex].length != EMPTY_SLOT && hashTable[hashIndex].isDeleted == 0){
         hashIndex = hashFunction(key,i,M,mode);
         i++;
     }
     
     if(hashTable[hashIndex].isDeleted == 0){
         //A suitable index with no element inserted before was found
-        hashTable[hashIndex].username = (char*) malloc(sizeof(char)*(strlen(username) + 1));
-        if(hashTable[hashIndex].username == NULL){
-            printf("Memory allocation error!");
-            exit(1);
-        }
-        *counter = *counter + 1;
-        strcpy(hashTable[hashIndex].username,username);
+        *used = *used + 1;
     }else{
-        //A suitable index with a deleted element was found
-        strcpy(hashTable[hashIndex].username,username);
-        hashTable[hashIndex].isDeleted = 0;
-        *counter = *counter + 1;
+        //A suitable index with a deleted element was found, its name is dropped
+        dropItemName(&hashTable[hashIndex],arena);
     }
+    setItemName(&hashTable[hashIndex],arena,username,length);
+    hashTable[hashIndex].isDeleted = 0;
+    hashTable[hashIndex].hash = key;
+    *counter = *counter + 1;
     if(mode == 1){
         printf("%s was inserted to [%d]\n",username,hashIndex);
     }else{
@@ -235,13 +835,90 @@ void insertToHashTable(HASH_ITEM* hashTable, int M, char* username,int mode, int
 }
 
 /*
-@brief Rehashes the given Hash Table using undeleted elements
+@brief Range of slots of a thread of the parallel rearrange and the state it shares with the other threads
+*/
+typedef struct REARRANGE_WORKER{
+    HASH_ITEM* hashTable;//Old slots
+    HASH_ITEM* newHashTable;
+    int M;
+    int start;//First slot of the range of the thread
+    int end;//Slot after the range of the thread
+    int placed;//Number of names that the thread placed
+    KEY_ARENA arena;//Long names of the new slots of the range, its chunks are given to the table afterwards
+    pthread_mutex_t* gate;//Held while the threads are started, the ranges are only known once it is released
+    pthread_barrier_t* barrier;
+}REARRANGE_WORKER;
+
+/*
+@brief Runs a thread of the parallel rearrange in three steps that are separated by barriers, after the gate is released: the new slots of its range are emptied,
+       the names of its old slots are placed, and the long names of its new slots are copied to its own arena.
+       A name claims a new slot by changing its length from EMPTY_SLOT with compare-and-swap, so the threads need no lock
+@param argument REARRANGE_WORKER of the thread
+@return NULL
+*/
+void* runRearrangeWorker(void* argument){
+    REARRANGE_WORKER* worker = (REARRANGE_WORKER*) argument;
+    HASH_ITEM* item;
+    int i, j, hashIndex, expected;
+    pthread_mutex_lock(worker->gate);
+    pthread_mutex_unlock(worker->gate);
+    for(i=worker->start;i<worker->end;i++){
+        worker->newHashTable[i].length = EMPTY_SLOT;
+        worker->newHashTable[i].isDeleted = 0;
+    }
+    pthread_barrier_wait(worker->barrier);
+
+    for(i=worker->start;i<worker->end;i++){
+        item = &worker->hashTable[i];
+        if(item->isDeleted == 1 || item->length == EMPTY_SLOT){
+            continue;
+        }
+        j = 0;
+        do{
+            hashIndex = hashFunction(item->hash,j,worker->M,1);
+            expected = EMPTY_SLOT;
+            j++;
+        }while(!__atomic_compare_exchange_n(&worker->newHashTable[hashIndex].length,&expected,item->length,0,
+                                            __ATOMIC_RELAXED,__ATOMIC_RELAXED));
+        //The other fields of a claimed slot are only read after the next barrier
+        worker->newHashTable[hashIndex].hash = item->hash;
+        worker->newHashTable[hashIndex].name = item->name;
+        worker->placed++;
+    }
+    pthread_barrier_wait(worker->barrier);
+
+    moveNamesToArena(worker->newHashTable + worker->start,worker->end - worker->start,&worker->arena);
+    return NULL;
+}
+
+/*
+@brief Finds the number of threads of a parallel rearrange, every thread gets at least REARRANGE_CUTOFF slots
+@param M Size of the Hash Table
+@return Number of threads, 1 if the table is rearranged serially
+*/
+int rearrangeThreadCount(int M){
+    long threadCount = sysconf(_SC_NPROCESSORS_ONLN);
+    if(threadCount > M / REARRANGE_CUTOFF){
+        threadCount = M / REARRANGE_CUTOFF;
+    }
+    if(threadCount > MAX_THREADS){
+        threadCount = MAX_THREADS;
+    }
+    return threadCount < 1 ? 1 : (int)threadCount;
+}
+
+/*
+@brief Rehashes the given Hash Table using undeleted elements. Names are moved to the new table with their cached hash values,
+       so they are not hashed or searched again, then the key arena is compacted. Large tables are rearranged by several threads
+       that place the names of their ranges without locks. Nothing is printed outside debug mode, which is always serial
 @param hashTable Hash Table to be rehashed
 @param M Size of the Hash Table
 @param mode Mode in which the program is run (1 = Normal Mode, 2 = Debug Mode)
+@param counter Number of names in the new table is written to it
+@param arena Key arena of the table
 @return New Hash Table
 */
-HASH_ITEM* rearrange(HASH_ITEM* hashTable, int M, int mode, int* counter, int N){
+HASH_ITEM* rearrange(HASH_ITEM* hashTable, int M, int mode, int* counter, KEY_ARENA* arena){
     
     HASH_ITEM* newHashTable = (HASH_ITEM*) malloc(sizeof(HASH_ITEM)*M);
     if(newHashTable == NULL){
@@ -249,16 +926,87 @@ HASH_ITEM* rearrange(HASH_ITEM* hashTable, int M, int mode, int* counter, int N)
         exit(1);
     }
 
-	int i;
+    int i, threadCount = mode == 2 ? 1 : rearrangeThreadCount(M);
+    if(threadCount > 1){
+        REARRANGE_WORKER* workers[MAX_THREADS];
+        REARRANGE_WORKER slots[MAX_THREADS];
+        pthread_t threads[MAX_THREADS];
+        pthread_mutex_t gate = PTHREAD_MUTEX_INITIALIZER;
+        pthread_barrier_t barrier;
+        ARENA_CHUNK* last;
+        int started = 0;
+        //The threads wait at the gate until the ranges and the barrier are sized to the threads that could be started
+        pthread_mutex_lock(&gate);
+        for(i=0;i<threadCount;i++){
+            slots[i].gate = &gate;
+            slots[i].barrier = &barrier;
+            if(pthread_create(&threads[started],NULL,runRearrangeWorker,&slots[i]) == 0){
+                workers[started] = &slots[i];
+                started++;
+            }
+        }
+        if(started > 0){
+            pthread_barrier_init(&barrier,NULL,started);
+        }
+        for(i=0;i<started;i++){
+            workers[i]->hashTable = hashTable;
+            workers[i]->newHashTable = newHashTable;
+            workers[i]->M = M;
+            workers[i]->start = (int)((long long)M*i/started);
+            workers[i]->end = (int)((long long)M*(i + 1)/started);
+            workers[i]->placed = 0;
+            workers[i]->arena.chunks = NULL;
+            workers[i]->arena.live = 0;
+            workers[i]->arena.garbage = 0;
+        }
+        pthread_mutex_unlock(&gate);
+        for(i=0;i<started;i++){
+            pthread_join(threads[i],NULL);
+        }
+        pthread_mutex_destroy(&gate);
+        //If no thread could be started the table is rearranged serially
+        if(started > 0){
+            //The old chunks are freed once all long names were copied to the arenas of the threads
+            freeArenaChunks(arena);
+            for(i=0;i<started;i++){
+                *counter = *counter + workers[i]->placed;
+                //The chunks of the thread are put in front of the chunks of the table
+                if(workers[i]->arena.chunks != NULL){
+                    for(last=workers[i]->arena.chunks;last->next != NULL;last=last->next);
+                    last->next = arena->chunks;
+                    arena->chunks = workers[i]->arena.chunks;
+                    arena->live += workers[i]->arena.live;
+                }
+            }
+            pthread_barrier_destroy(&barrier);
+            free(hashTable);
+            return newHashTable;
+        }
+    }
+
 	for(i=0;i<M;i++){
-    	newHashTable[i].username = NULL;
+    	newHashTable[i].length = EMPTY_SLOT;
         newHashTable[i].isDeleted = 0;
     }
     
+    int hashIndex, j;
     for(i=0;i<M;i++){
         //Names that were not deleted in the old table are inserted to the new table
-        if(hashTable[i].isDeleted == 0 && hashTable[i].username != NULL){
-            insertToHashTable(newHashTable,M,hashTable[i].username,mode, counter, N);
+        if(hashTable[i].isDeleted == 0 && hashTable[i].length != EMPTY_SLOT){
+            if(mode == 2){
+                printf("\nInserting %s\n",itemName(&hashTable[i]));
+            }
+            hashIndex = hashFunction(hashTable[i].hash,0,M,mode);
+            j = 1;
+            while(newHashTable[hashIndex].length != EMPTY_SLOT){
+                hashIndex = hashFunction(hashTable[i].hash,j,M,mode);
+                j++;
+            }
+            newHashTable[hashIndex] = hashTable[i];
+            *counter = *counter + 1;
+            if(mode == 2){
+                printf("%s was inserted to [%d] after %d attempts\n",itemName(&hashTable[i]),hashIndex,j);
+            }
         }
     }
     if(mode == 2){
@@ -266,94 +1014,3298 @@ HASH_ITEM* rearrange(HASH_ITEM* hashTable, int M, int mode, int* counter, int N)
     }
     
     free(hashTable);
+    //Names of the tombstones are not copied, so their bytes are given back
+    compactArena(newHashTable,M,arena);
     return newHashTable;
 }
 
-int main(){
-    int N;//Maximum number of elements
-    int M;//Size of hash table
-    int choice;//transaction number to be selected
-    float loadFactor;//Load Factor of hash table
-    char *username;
-    int mode;//Program mode
-    int counter = 0;//Number of names in the table that have not been deleted
-
-    printf("Enter 1 to run in normal mode and 2 for debug mode(1/2): ");
-    scanf("%d",&mode);
-    printf("Enter the maximum number of elements(N): ");
-    scanf("%d",&N);
-    printf("Enter the Load Factor(alpha): ");
-    scanf("%f",&loadFactor);
-    printf("Enter the table size(M): ");
-    scanf("%d",&M);
+/*
+@brief Places a name whose hash value is known to the first empty or deleted slot of its probe sequence without printing.
+       The name is not copied to the arena again, the slot takes the name of item
+@param hashTable Hash Table to be inserted
+@param M Size of the Hash Table
+@param item Name and hash value to be placed
+@param used Number of slots that have a name or a tombstone, it is increased if an empty slot is used
+@param arena Key arena of the table
+@return Index of the name in the Hash Table
+*/
+int placeInHashTable(HASH_ITEM* hashTable, int M, HASH_ITEM item, int* used, KEY_ARENA* arena){
+    int hashIndex = hashFunction(item.hash,0,M,1);
+    int i = 1;
+    while(hashTable[hashIndex].length != EMPTY_SLOT && hashTable[hashIndex].isDeleted == 0){
+        hashIndex = hashFunction(item.hash,i,M,1);
+        i++;
+    }
+    if(hashTable[hashIndex].length == EMPTY_SLOT){
+        *used = *used + 1;
+    }else{
+        dropItemName(&hashTable[hashIndex],arena);
+    }
+    hashTable[hashIndex] = item;
+    hashTable[hashIndex].isDeleted = 0;
+    return hashIndex;
+}
 
-    //Hash Table Initialization
-    HASH_ITEM* hashTable = (HASH_ITEM*) malloc(sizeof(HASH_ITEM)*M);
-    if(hashTable == NULL){
-        printf("Memory allocation error!");
-        exit(1);
+/*
+@brief Finds the smallest prime number that is not smaller than n
+@param n Lower bound
+@return Prime number
+*/
+int nextPrime(int n){
+    int i, isPrime;
+    if(n <= 3){
+        return 3;
+    }
+    while(1){
+        isPrime = 1;
+        for(i=2;(long long)i*i<=n && isPrime;i++){
+            if(n % i == 0){
+                isPrime = 0;
+            }
+        }
+        if(isPrime){
+            return n;
+        }
+        n++;
     }
+}
 
+/*
+@brief Finds the slots of a control group whose control byte is equal to the given value
+@param control First control byte of the group
+@param value Control byte to be matched
+@return Bit mask of the matching slots, bit i is set if slot i of the group matches
+*/
+unsigned matchControlGroup(int8_t* control, int8_t value){
+#ifdef __SSE2__
+    __m128i group = _mm_loadu_si128((const __m128i*)control);
+    return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(group,_mm_set1_epi8(value)));
+#else
+    unsigned mask = 0;
     int i;
-    for(i=0;i<M;i++){
-    	hashTable[i].username = NULL;
-        hashTable[i].isDeleted = 0;
+    for(i=0;i<GROUP_SIZE;i++){
+        if(control[i] == value){
+            mask |= 1u << i;
+        }
     }
-    
-    //Fill the table with some names
-    insertToHashTable(hashTable,M,"bilal",mode,&counter,N);
-    insertToHashTable(hashTable,M,"mustafa",mode,&counter,N);
-    insertToHashTable(hashTable,M,"ali",mode,&counter,N);
-    insertToHashTable(hashTable,M,"mehmet",mode,&counter,N);
-    insertToHashTable(hashTable,M,"veli",mode,&counter,N);
-    insertToHashTable(hashTable,M,"ayse",mode,&counter,N);
-    insertToHashTable(hashTable,M,"fatma",mode,&counter,N);
-    
-    printHashTable(hashTable,M);
+    return mask;
+#endif
+}
 
-    while(1){
-        printf("\n\n1-Insert\n2-Search\n3-Remove\n4-Print\n5-Rearrange\n6-Exit\n\n");
-        scanf("%d",&choice);
-		username = (char*) malloc(sizeof(char)*30);
-		
-        switch(choice){
-            case 1:
-                printf("Enter the user name: ");
-                scanf("%s",username);
-                insertToHashTable(hashTable,M,username,mode,&counter,N);
-                break;
+/*
+@brief Finds the slots of a control group that are EMPTY or DELETED. Both have their sign bit set and fingerprints do not
+@param control First control byte of the group
+@return Bit mask of the free slots
+*/
+unsigned matchFreeSlots(int8_t* control){
+#ifdef __SSE2__
+    return (unsigned)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)control));
+#else
+    unsigned mask = 0;
+    int i;
+    for(i=0;i<GROUP_SIZE;i++){
+        if(control[i] < 0){
+            mask |= 1u << i;
+        }
+    }
+    return mask;
+#endif
+}
 
-            case 2:
-                printf("Enter the user name: ");
-                scanf("%s",username);
-                int index = searchInHashTable(hashTable,M,username,mode);
-                if(mode == 1){
-                    if(index != -1){
-                        printf("%s was found in %d\n",username,index);
-                    }else{
-                        printf("%s was not found in the table!\n",username);
-                    }
-                }else{
-                    printHashTable(hashTable, M);
-                }
+/*
+@brief Creates an empty Swiss Table that has at least M slots
+@param M Minimum size of the Swiss Table
+@param arena Key arena for the long names
+@return Created Swiss Table
+*/
+SWISS_TABLE* createSwissTable(int M, KEY_ARENA* arena){
+    SWISS_TABLE* table = (SWISS_TABLE*) malloc(sizeof(SWISS_TABLE));
+    int i;
+    if(table == NULL){
+        printf("Memory allocation error!");
+        exit(1);
+    }
+    table->groupCount = 1;
+    while(table->groupCount*GROUP_SIZE < M){
+        table->groupCount *= 2;
+    }
+    table->control = (int8_t*) malloc(sizeof(int8_t)*table->groupCount*GROUP_SIZE);
+    table->slots = (HASH_ITEM*) calloc(table->groupCount*GROUP_SIZE,sizeof(HASH_ITEM));
+    if(table->control == NULL || table->slots == NULL){
+        printf("Memory allocation error!");
+        exit(1);
+    }
+    memset(table->control,CONTROL_EMPTY,table->groupCount*GROUP_SIZE);
+    for(i=0;i<table->groupCount*GROUP_SIZE;i++){
+        table->slots[i].length = EMPTY_SLOT;
+    }
+    table->counter = 0;
+    table->deleted = 0;
+    table->arena = arena;
+    return table;
+}
+
+/*
+@brief Frees the given Swiss Table, its long names stay in the key arena
+@param table Swiss Table to be freed
+@return
+*/
+void freeSwissTable(SWISS_TABLE* table){
+    free(table->control);
+    free(table->slots);
+    free(table);
+}
+
+/*
+@brief Finds the slot of the given name in the Swiss Table. Groups are probed with triangular steps (1, 2, 3, ...), which visit every group
+       when the number of groups is a power of 2. The search stops at the first group that has an EMPTY slot
+@param table Swiss Table to be searched
+@param username Name to be searched
+@param length Length of the name
+@param hash Hash value of the name
+@param mode Mode in which the program is run (1 = Normal Mode, 2 = Debug Mode)
+@param attempts Number of probed groups is written to it
+@return Index of the name in the Swiss Table (-1 = Not Found)
+*/
+int findInSwissTable(SWISS_TABLE* table, char* username, int length, uint64_t hash, int mode, int* attempts){
+    int8_t h2 = (int8_t)(hash & 0x7F);
+    int groupMask = table->groupCount - 1;
+    int group = (int)((hash >> 7) & groupMask);
+    int8_t* control;
+    unsigned match;
+    int i, index;
+    for(i=0;i<table->groupCount;i++){
+        control = table->control + group*GROUP_SIZE;
+        match = matchControlGroup(control,h2);
+        if(mode == 2){
+            printf("Group = %d -- H2 = %d -- i = %d -- Matches = %04X\n",group,h2,i,match);
+        }
+        while(match != 0){
+            //Only the slots whose fingerprint matches are compared with the name
+            index = group*GROUP_SIZE + __builtin_ctz(match);
+            if(isSameName(&table->slots[index],username,length,hash)){
+                *attempts = i + 1;
+                return index;
+            }
+            match &= match - 1;
+        }
+        if(matchControlGroup(control,CONTROL_EMPTY) != 0){
+            break;
+        }
+        group = (group + i + 1) & groupMask;
+    }
+    *attempts = i + 1;
+    return -1;
+}
+
+/*
+@brief Finds the first EMPTY or DELETED slot on the probe sequence of a hash value
+@param table Swiss Table to be searched
+@param hash Hash value of the name to be placed
+@param attempts Number of probed groups is written to it
+@return Index of the free slot (-1 = The table is full)
+*/
+int findFreeSwissSlot(SWISS_TABLE* table, uint64_t hash, int* attempts){
+    int groupMask = table->groupCount - 1;
+    int group = (int)((hash >> 7) & groupMask);
+    unsigned match;
+    int i;
+    for(i=0;i<table->groupCount;i++){
+        match = matchFreeSlots(table->control + group*GROUP_SIZE);
+        if(match != 0){
+            *attempts = i + 1;
+            return group*GROUP_SIZE + __builtin_ctz(match);
+        }
+        group = (group + i + 1) & groupMask;
+    }
+    *attempts = i;
+    return -1;
+}
+
+/*
+@brief Searches the given name in the Swiss Table
+@param table Swiss Table to be searched
+@param username Name to be searched
+@param mode Mode in which the program is run (1 = Normal Mode, 2 = Debug Mode)
+@return Index of the name in the Swiss Table (-1 = Not Found)
+*/
+int searchInSwissTable(SWISS_TABLE* table, char* username, int mode){
+    if(mode == 2){
+        printf("\nSearching %s\n",username);
+    }
+    int length = (int)strlen(username);
+    int attempts;
+    int index = findInSwissTable(table,username,length,hashName(username,length),mode,&attempts);
+    if(mode == 2){
+        if(index != -1){
+            printf("%s was found in [%d] after %d attempts\n",username,index,attempts);
+        }else{
+            printf("%s was not found after %d attempts!\n",username,attempts);
+        }
+    }
+    return index;
+}
+
+/*
+@brief Inserts the given name to the Swiss Table
+@param table Swiss Table to be inserted
+@param username Name to be inserted
+@param mode Mode in which the program is run (1 = Normal Mode, 2 = Debug Mode)
+@return
+*/
+void insertToSwissTable(SWISS_TABLE* table, char* username, int mode){
+    if(mode == 2){
+        printf("\nInserting %s\n",username);
+    }
+
+    //The search is performed before the name is inserted to the table
+    int length = (int)strlen(username);
+    uint64_t hash = hashName(username,length);
+    int attempts;
+    if(findInSwissTable(table,username,length,hash,1,&attempts) != -1){
+        printf("%s is already in the table!\n",username);
+        return;
+    }
+    int index = findFreeSwissSlot(table,hash,&attempts);
+    if(index == -1){
+        printf("The table is full!\n");
+        return;
+    }
+    if(table->control[index] == CONTROL_DELETED){
+        table->deleted--;
+    }
+    setItemName(&table->slots[index],table->arena,username,length);
+    table->slots[index].isDeleted = 0;
+    table->slots[index].hash = hash;
+    table->control[index] = (int8_t)(hash & 0x7F);
+    table->counter++;
+    if(mode == 1){
+        printf("%s was inserted to [%d]\n",username,index);
+    }else{
+        printf("%s was inserted to [%d] after %d attempts\n",username,index,attempts);
+    }
+}
+
+/*
+@brief Empties a slot of the Swiss Table. The slot becomes EMPTY if its group still has an EMPTY slot, because then no search
+       has continued past this group. Otherwise it becomes DELETED so that searches continue to the next group
+@param table Swiss Table
+@param index Index of the slot to be emptied
+@return
+*/
+void deleteSwissSlot(SWISS_TABLE* table, int index){
+    int group = index / GROUP_SIZE;
+    if(matchControlGroup(table->control + group*GROUP_SIZE,CONTROL_EMPTY) != 0){
+        table->control[index] = CONTROL_EMPTY;
+    }else{
+        table->control[index] = CONTROL_DELETED;
+        table->slots[index].isDeleted = 1;
+        table->deleted++;
+    }
+    dropItemName(&table->slots[index],table->arena);
+    table->slots[index].length = EMPTY_SLOT;
+    table->counter--;
+}
+
+/*
+@brief Removes the given name from the Swiss Table
+@param table Swiss Table to be removed from
+@param username Name to be removed
+@param mode Mode in which the program is run (1 = Normal Mode, 2 = Debug Mode)
+@return
+*/
+void removeFromSwissTable(SWISS_TABLE* table, char* username, int mode){
+    if(mode == 2){
+        printf("\nRemoving %s\n",username);
+    }
+    int length = (int)strlen(username);
+    int attempts;
+    int index = findInSwissTable(table,username,length,hashName(username,length),mode,&attempts);
+    if(index == -1){
+        if(mode == 2){
+            printf("%s was not found after %d attempts!\n",username,attempts);
+        }else{
+            printf("%s was not found in the table!\n",username);
+        }
+        return;
+    }
+    deleteSwissSlot(table,index);
+    if(mode == 2){
+        printf("%s was removed from [%d] after %d attempts\n",username,index,attempts);
+    }else{
+        printf("%s was removed from [%d]\n",username,index);
+    }
+}
+
+/*
+@brief Prints the given Swiss Table
+@param table Swiss Table to be printed
+@return
+*/
+void printSwissTable(SWISS_TABLE* table){
+    printf("\n");
+    int i;
+    for(i=0;i<table->groupCount*GROUP_SIZE;i++){
+        printf("%d: %s (%d)\n",i,itemName(&table->slots[i]),table->control[i] == CONTROL_DELETED);
+    }
+}
+
+/*
+@brief Places a name whose hash value is known to the first free slot of its probe sequence without printing. The name is not copied
+@param table Swiss Table to be inserted, it must have a free slot
+@param item Name and hash value to be placed
+@return Index of the name in the Swiss Table
+*/
+int placeInSwissTable(SWISS_TABLE* table, HASH_ITEM item){
+    int attempts;
+    int index = findFreeSwissSlot(table,item.hash,&attempts);
+    if(table->control[index] == CONTROL_DELETED){
+        table->deleted--;
+    }
+    item.isDeleted = 0;
+    table->slots[index] = item;
+    table->control[index] = (int8_t)(item.hash & 0x7F);
+    table->counter++;
+    return index;
+}
+
+/*
+@brief Rehashes the given Swiss Table so that all DELETED slots become EMPTY. Names are moved to the new slots with their cached hash values,
+       they are not hashed again, then the key arena is compacted
+@param table Swiss Table to be rehashed
+@param mode Mode in which the program is run (1 = Normal Mode, 2 = Debug Mode)
+@return
+*/
+void rearrangeSwissTable(SWISS_TABLE* table, int mode){
+    int slotCount = table->groupCount*GROUP_SIZE;
+    HASH_ITEM* oldSlots = table->slots;
+    int8_t* oldControl = table->control;
+    table->control = (int8_t*) malloc(sizeof(int8_t)*slotCount);
+    table->slots = (HASH_ITEM*) calloc(slotCount,sizeof(HASH_ITEM));
+    if(table->control == NULL || table->slots == NULL){
+        printf("Memory allocation error!");
+        exit(1);
+    }
+    memset(table->control,CONTROL_EMPTY,slotCount);
+
+    table->counter = 0;
+    table->deleted = 0;
+
+    int i, index;
+    for(i=0;i<slotCount;i++){
+        table->slots[i].length = EMPTY_SLOT;
+    }
+    for(i=0;i<slotCount;i++){
+        if(oldControl[i] >= 0){
+            //Names that were not deleted in the old table are moved to the new table with their cached hash values
+            index = placeInSwissTable(table,oldSlots[i]);
+            if(mode == 2){
+                printf("%s was moved from [%d] to [%d]\n",itemName(&oldSlots[i]),i,index);
+            }
+        }
+    }
+    free(oldSlots);
+    free(oldControl);
+    compactArena(table->slots,slotCount,table->arena);
+    if(mode == 2){
+        printSwissTable(table);
+    }
+}
+
+/*
+@brief Creates an empty Robin Hood Table that has at least M slots
+@param M Minimum size of the Robin Hood Table
+@param arena Key arena for the long names
+@return Created Robin Hood Table
+*/
+ROBIN_TABLE* createRobinTable(int M, KEY_ARENA* arena){
+    ROBIN_TABLE* table = (ROBIN_TABLE*) malloc(sizeof(ROBIN_TABLE));
+    int i;
+    if(table == NULL){
+        printf("Memory allocation error!");
+        exit(1);
+    }
+    table->size = GROUP_SIZE;
+    while(table->size < M){
+        table->size *= 2;
+    }
+    table->slots = (HASH_ITEM*) malloc(sizeof(HASH_ITEM)*table->size);
+    if(table->slots == NULL){
+        printf("Memory allocation error!");
+        exit(1);
+    }
+    for(i=0;i<table->size;i++){
+        table->slots[i].length = EMPTY_SLOT;
+        table->slots[i].isDeleted = 0;
+        table->slots[i].hash = 0;
+    }
+    table->counter = 0;
+    table->arena = arena;
+    return table;
+}
+
+/*
+@brief Frees the given Robin Hood Table, its long names stay in the key arena
+@param table Robin Hood Table to be freed
+@return
+*/
+void freeRobinTable(ROBIN_TABLE* table){
+    free(table->slots);
+    free(table);
+}
+
+/*
+@brief Finds how far the name of a slot is from its home slot
+@param table Robin Hood Table
+@param index Index of a slot that is not empty
+@return Number of slots between the home slot of the name and its slot
+*/
+int robinDistance(ROBIN_TABLE* table, int index){
+    return (index - (int)(table->slots[index].hash & (table->size - 1))) & (table->size - 1);
+}
+
+/*
+@brief Finds the slot of the given name in the Robin Hood Table. The search stops at an empty slot or at a name that is closer to its
+       home than the searched name would be, because the name would have taken that slot when it was inserted
+@param table Robin Hood Table to be searched
+@param username Name to be searched
+@param length Length of the name
+@param hash Hash value of the name
+@param mode Mode in which the program is run (1 = Normal Mode, 2 = Debug Mode)
+@param attempts Number of probed slots is written to it
+@return Index of the name in the Robin Hood Table (-1 = Not Found)
+*/
+int findInRobinTable(ROBIN_TABLE* table, char* username, int length, uint64_t hash, int mode, int* attempts){
+    int mask = table->size - 1;
+    int index = (int)(hash & mask);
+    int i;
+    for(i=0;i<table->size;i++){
+        if(table->slots[index].length == EMPTY_SLOT || robinDistance(table,index) < i){
+            break;
+        }
+        if(mode == 2){
+            printf("Index = %d -- Distance = %d -- i = %d\n",index,robinDistance(table,index),i);
+        }
+        if(isSameName(&table->slots[index],username,length,hash)){
+            *attempts = i + 1;
+            return index;
+        }
+        index = (index + 1) & mask;
+    }
+    *attempts = i + 1;
+    return -1;
+}
+
+/*
+@brief Places a name whose hash value is known without printing. Going from its home slot, the name takes the first slot whose name is
+       closer to its own home, and the displaced name goes on in the same way until an empty slot is found
+@param table Robin Hood Table to be inserted, it must have an empty slot
+@param item Name and hash value to be placed
+@return Index of the placed name in the Robin Hood Table
+*/
+int placeInRobinTable(ROBIN_TABLE* table, HASH_ITEM item){
+    int mask = table->size - 1;
+    int index = (int)(item.hash & mask);
+    int distance = 0, placed = -1, slotDistance;
+    HASH_ITEM displaced;
+    item.isDeleted = 0;
+    while(table->slots[index].length != EMPTY_SLOT){
+        slotDistance = robinDistance(table,index);
+        if(slotDistance < distance){
+            //The name of the slot is closer to its home, it gives its slot to the carried name and is carried further
+            displaced = table->slots[index];
+            table->slots[index] = item;
+            item = displaced;
+            distance = slotDistance;
+            if(placed == -1){
+                placed = index;
+            }
+        }
+        index = (index + 1) & mask;
+        distance++;
+    }
+    table->slots[index] = item;
+    table->counter++;
+    return placed == -1 ? index : placed;
+}
+
+/*
+@brief Empties a slot of the Robin Hood Table. The following names that are not in their home slots are shifted one slot back,
+       so no tombstone is left and their probe sequences get shorter
+@param table Robin Hood Table
+@param index Index of the slot to be emptied
+@return
+*/
+void deleteRobinSlot(ROBIN_TABLE* table, int index){
+    int mask = table->size - 1;
+    int next = (index + 1) & mask;
+    dropItemName(&table->slots[index],table->arena);
+    while(table->slots[next].length != EMPTY_SLOT && robinDistance(table,next) > 0){
+        table->slots[index] = table->slots[next];
+        index = next;
+        next = (next + 1) & mask;
+    }
+    table->slots[index].length = EMPTY_SLOT;
+    table->counter--;
+}
+
+/*
+@brief Searches the given name in the Robin Hood Table
+@param table Robin Hood Table to be searched
+@param username Name to be searched
+@param mode Mode in which the program is run (1 = Normal Mode, 2 = Debug Mode)
+@return Index of the name in the Robin Hood Table (-1 = Not Found)
+*/
+int searchInRobinTable(ROBIN_TABLE* table, char* username, int mode){
+    if(mode == 2){
+        printf("\nSearching %s\n",username);
+    }
+    int length = (int)strlen(username);
+    int attempts;
+    int index = findInRobinTable(table,username,length,hashName(username,length),mode,&attempts);
+    if(mode == 2){
+        if(index != -1){
+            printf("%s was found in [%d] after %d attempts\n",username,index,attempts);
+        }else{
+            printf("%s was not found after %d attempts!\n",username,attempts);
+        }
+    }
+    return index;
+}
+
+/*
+@brief Inserts the given name to the Robin Hood Table
+@param table Robin Hood Table to be inserted, it must have an empty slot
+@param username Name to be inserted
+@param mode Mode in which the program is run (1 = Normal Mode, 2 = Debug Mode)
+@return
+*/
+void insertToRobinTable(ROBIN_TABLE* table, char* username, int mode){
+    if(mode == 2){
+        printf("\nInserting %s\n",username);
+    }
+
+    //The search is performed before the name is inserted to the table
+    int length = (int)strlen(username);
+    uint64_t hash = hashName(username,length);
+    int attempts;
+    if(findInRobinTable(table,username,length,hash,1,&attempts) != -1){
+        printf("%s is already in the table!\n",username);
+        return;
+    }
+    HASH_ITEM item;
+    setItemName(&item,table->arena,username,length);
+    item.hash = hash;
+    int index = placeInRobinTable(table,item);
+    if(mode == 1){
+        printf("%s was inserted to [%d]\n",username,index);
+    }else{
+        printf("%s was inserted to [%d] after %d attempts\n",username,index,robinDistance(table,index) + 1);
+    }
+}
+
+/*
+@brief Removes the given name from the Robin Hood Table with backward-shift deletion
+@param table Robin Hood Table to be removed from
+@param username Name to be removed
+@param mode Mode in which the program is run (1 = Normal Mode, 2 = Debug Mode)
+@return
+*/
+void removeFromRobinTable(ROBIN_TABLE* table, char* username, int mode){
+    if(mode == 2){
+        printf("\nRemoving %s\n",username);
+    }
+    int length = (int)strlen(username);
+    int attempts;
+    int index = findInRobinTable(table,username,length,hashName(username,length),mode,&attempts);
+    if(index == -1){
+        if(mode == 2){
+            printf("%s was not found after %d attempts!\n",username,attempts);
+        }else{
+            printf("%s was not found in the table!\n",username);
+        }
+        return;
+    }
+    deleteRobinSlot(table,index);
+    if(mode == 2){
+        printf("%s was removed from [%d] after %d attempts\n",username,index,attempts);
+    }else{
+        printf("%s was removed from [%d]\n",username,index);
+    }
+}
+
+/*
+@brief Prints the given Robin Hood Table, the distance of every name from its home slot is printed next to it
+@param table Robin Hood Table to be printed
+@return
+*/
+void printRobinTable(ROBIN_TABLE* table){
+    printf("\n");
+    int i;
+    for(i=0;i<table->size;i++){
+        printf("%d: %s (%d)\n",i,itemName(&table->slots[i]),table->slots[i].length < 0 ? 0 : robinDistance(table,i));
+    }
+}
+
+/*
+@brief Finds the name of a slot of the persistent table
+@param table Persistent table
+@param slot Slot of the table
+@return Name of the slot, NULL if it has no name
+*/
+char* persistentName(PERSISTENT_TABLE* table, PERSISTENT_SLOT* slot){
+    if(slot->length < 0){
+        return NULL;
+    }
+    return slot->length < INLINE_NAME ? slot->name.inlined : table->keys + slot->name.offset;
+}
+
+/*
+@brief Appends bytes to the records of the write-ahead log in memory
+@param table Persistent table
+@param data Bytes to be appended
+@param length Number of bytes
+@return
+*/
+void appendToLog(PERSISTENT_TABLE* table, const void* data, size_t length){
+    if(table->walSize + length > table->walCapacity){
+        while(table->walSize + length > table->walCapacity){
+            table->walCapacity = table->walCapacity > 0 ? 2*table->walCapacity : 4096;
+        }
+        table->wal = (char*) realloc(table->wal,table->walCapacity);
+        if(table->wal == NULL){
+            printf("Memory allocation error!");
+            exit(1);
+        }
+    }
+    memcpy(table->wal + table->walSize,data,length);
+    table->walSize += length;
+}
+
+/*
+@brief Starts a record of the write-ahead log, its header is filled by endRecord
+@param table Persistent table
+@return
+*/
+void beginRecord(PERSISTENT_TABLE* table){
+    char header[16] = {0};
+    table->recordStart = table->walSize;
+    appendToLog(table,header,sizeof(header));
+}
+
+/*
+@brief Adds bytes of the mapping that were changed to the current record, with their offset in the file
+@param table Persistent table
+@param address First changed byte in the mapping
+@param length Number of changed bytes
+@return
+*/
+void logChange(PERSISTENT_TABLE* table, void* address, uint32_t length){
+    uint64_t offset = (uint64_t)((char*)address - table->map);
+    appendToLog(table,&offset,sizeof(offset));
+    appendToLog(table,&length,sizeof(length));
+    appendToLog(table,address,length);
+}
+
+/*
+@brief Finishes the current record: its header gets the magic number, the size and the checksum of its changes, so a record that was
+       not written completely is recognized when the log is read
+@param table Persistent table
+@return
+*/
+void endRecord(PERSISTENT_TABLE* table){
+    uint32_t magic = WAL_MAGIC;
+    uint32_t size = (uint32_t)(table->walSize - table->recordStart - 16);
+    uint64_t checksum = calculateFastHash(table->wal + table->recordStart + 16,size);
+    memcpy(table->wal + table->recordStart,&magic,sizeof(magic));
+    memcpy(table->wal + table->recordStart + 4,&size,sizeof(size));
+    memcpy(table->wal + table->recordStart + 8,&checksum,sizeof(checksum));
+    table->recordStart = table->walSize;
+}
+
+/*
+@brief Writes the changes of the valid records of a log to the table file. Reading stops at the first record that is incomplete,
+       has a wrong checksum or writes outside of the file
+@param fd Table file
+@param records Records of the log
+@param size Number of bytes of the records
+@param fileSize Size of the table file
+@return Number of bytes of the valid records
+*/
+size_t applyRecords(int fd, char* records, size_t size, size_t fileSize){
+    size_t position = 0, entry;
+    uint32_t magic, recordSize, length;
+    uint64_t checksum, offset;
+    while(position + 16 <= size){
+        memcpy(&magic,records + position,sizeof(magic));
+        memcpy(&recordSize,records + position + 4,sizeof(recordSize));
+        memcpy(&checksum,records + position + 8,sizeof(checksum));
+        if(magic != WAL_MAGIC || recordSize > size - position - 16 ||
+           calculateFastHash(records + position + 16,recordSize) != checksum){
+            break;
+        }
+        //The entries are checked before anything is written, so a record is applied completely or not at all
+        for(entry=position + 16;entry + 12 <= position + 16 + recordSize;entry += 12 + length){
+            memcpy(&offset,records + entry,sizeof(offset));
+            memcpy(&length,records + entry + 8,sizeof(length));
+            if(length > position + 16 + recordSize - entry - 12 || offset > fileSize || length > fileSize - offset){
+                break;
+            }
+        }
+        if(entry != position + 16 + recordSize){
+            break;
+        }
+        for(entry=position + 16;entry < position + 16 + recordSize;entry += 12 + length){
+            memcpy(&offset,records + entry,sizeof(offset));
+            memcpy(&length,records + entry + 8,sizeof(length));
+            if(pwrite(fd,records + entry + 12,length,(off_t)offset) != (ssize_t)length){
+                printf("The table file could not be written!\n");
+                exit(1);
+            }
+        }
+        position += 16 + recordSize;
+    }
+    return position;
+}
+
+/*
+@brief Copies the logged changes to the table file and empties the log once the file is synchronized. The mapping already has the
+       result of all records, so the pages that the records touch are written from it in runs instead of one write per change
+@param table Persistent table, it must not have an unfinished record
+@return
+*/
+void checkpointPersistentTable(PERSISTENT_TABLE* table){
+    size_t pageCount = (table->mapSize + CHECKPOINT_PAGE - 1) / CHECKPOINT_PAGE;
+    char* dirty;
+    size_t position, entry, first, last, page, end;
+    uint32_t recordSize, length;
+    uint64_t offset;
+    if(table->walSize == 0){
+        return;
+    }
+    dirty = (char*) calloc(pageCount,sizeof(char));
+    if(dirty == NULL){
+        printf("Memory allocation error!");
+        exit(1);
+    }
+    for(position=0;position < table->walSize;position += 16 + recordSize){
+        memcpy(&recordSize,table->wal + position + 4,sizeof(recordSize));
+        for(entry=position + 16;entry < position + 16 + recordSize;entry += 12 + length){
+            memcpy(&offset,table->wal + entry,sizeof(offset));
+            memcpy(&length,table->wal + entry + 8,sizeof(length));
+            last = (offset + length - 1) / CHECKPOINT_PAGE;
+            for(page=offset / CHECKPOINT_PAGE;page <= last;page++){
+                dirty[page] = 1;
+            }
+        }
+    }
+    for(first=0;first < pageCount;first = last){
+        if(dirty[first] == 0){
+            last = first + 1;
+            continue;
+        }
+        for(last=first;last < pageCount && dirty[last] == 1;last++);
+        end = last*CHECKPOINT_PAGE < table->mapSize ? last*CHECKPOINT_PAGE : table->mapSize;
+        if(pwrite(table->fd,table->map + first*CHECKPOINT_PAGE,end - first*CHECKPOINT_PAGE,(off_t)(first*CHECKPOINT_PAGE)) != (ssize_t)(end - first*CHECKPOINT_PAGE)){
+            printf("The table file could not be written!\n");
+            exit(1);
+        }
+    }
+    free(dirty);
+    if(fdatasync(table->fd) != 0 || ftruncate(table->walFd,0) != 0 || fdatasync(table->walFd) != 0){
+        printf("The table file could not be synchronized!\n");
+        exit(1);
+    }
+    table->walSize = 0;
+    table->walCommitted = 0;
+    table->recordStart = 0;
+}
+
+/*
+@brief Writes the finished records that are not in the log file yet and waits until they are on the disk.
+       The log is checkpointed when it is longer than WAL_LIMIT
+@param table Persistent table
+@return
+*/
+void commitPersistentTable(PERSISTENT_TABLE* table){
+    ssize_t written;
+    if(table->walCommitted == table->walSize){
+        return;
+    }
+    while(table->walCommitted < table->walSize){
+        written = pwrite(table->walFd,table->wal + table->walCommitted,table->walSize - table->walCommitted,(off_t)table->walCommitted);
+        if(written <= 0){
+            printf("The write-ahead log could not be written!\n");
+            exit(1);
+        }
+        table->walCommitted += written;
+    }
+    if(fdatasync(table->walFd) != 0){
+        printf("The write-ahead log could not be synchronized!\n");
+        exit(1);
+    }
+    if(table->walSize > WAL_LIMIT){
+        checkpointPersistentTable(table);
+    }
+}
+
+/*
+@brief Synchronizes the directory of a file, so a file that was created or renamed in it is found after a crash
+@param path Path of the file
+@return
+*/
+void syncDirectory(char* path){
+    char* slash = strrchr(path,'/');
+    char* directory;
+    int fd;
+    if(slash == NULL){
+        directory = strdup(".");
+    }else{
+        directory = strndup(path,slash == path ? 1 : (size_t)(slash - path));
+    }
+    fd = open(directory,O_RDONLY);
+    if(fd >= 0){
+        fsync(fd);
+        close(fd);
+    }
+    free(directory);
+}
+
+/*
+@brief Creates a table file and writes the names of a persistent table to it with linear probing, tombstones are not copied.
+       The file is synchronized before the function returns
+@param path Path of the new file
+@param source Persistent table whose names are copied, NULL for an empty table
+@param slotCount Number of slots, a power of 2
+@param keyCapacity Size of the key area, it must hold the long names of source
+@return
+*/
+void writePersistentFile(char* path, PERSISTENT_TABLE* source, uint64_t slotCount, uint64_t keyCapacity){
+    size_t size = sizeof(PERSISTENT_HEADER) + sizeof(PERSISTENT_SLOT)*slotCount + keyCapacity;
+    int fd = open(path,O_RDWR | O_CREAT | O_TRUNC,0644);
+    PERSISTENT_HEADER* header;
+    PERSISTENT_SLOT* slots;
+    PERSISTENT_SLOT* slot;
+    char* keys;
+    char* map;
+    uint64_t i, index;
+    if(fd < 0 || ftruncate(fd,(off_t)size) != 0){
+        printf("%s could not be created!\n",path);
+        exit(1);
+    }
+    map = (char*) mmap(NULL,size,PROT_READ | PROT_WRITE,MAP_SHARED,fd,0);
+    if(map == MAP_FAILED){
+        printf("%s could not be mapped!\n",path);
+        exit(1);
+    }
+    header = (PERSISTENT_HEADER*) map;
+    slots = (PERSISTENT_SLOT*) (map + sizeof(PERSISTENT_HEADER));
+    keys = map + sizeof(PERSISTENT_HEADER) + sizeof(PERSISTENT_SLOT)*slotCount;
+    memcpy(header->magic,PERSISTENT_MAGIC,sizeof(header->magic));
+    header->hashFunction = hashName == calculateFnvHash ? 2 : 1;
+    header->slotCount = slotCount;
+    header->counter = 0;
+    header->used = 0;
+    header->keyBytes = 0;
+    header->keyCapacity = keyCapacity;
+    for(i=0;i<slotCount;i++){
+        slots[i].length = EMPTY_SLOT;
+    }
+    for(i=0;source != NULL && i<source->header->slotCount;i++){
+        slot = &source->slots[i];
+        if(slot->length < 0 || slot->isDeleted == 1){
+            continue;
+        }
+        index = slot->hash & (slotCount - 1);
+        while(slots[index].length != EMPTY_SLOT){
+            index = (index + 1) & (slotCount - 1);
+        }
+        slots[index] = *slot;
+        if(slot->length >= INLINE_NAME){
+            memcpy(keys + header->keyBytes,source->keys + slot->name.offset,slot->length + 1);
+            slots[index].name.offset = header->keyBytes;
+            header->keyBytes += slot->length + 1;
+        }
+        header->counter++;
+        header->used++;
+    }
+    if(msync(map,size,MS_SYNC) != 0 || fsync(fd) != 0){
+        printf("%s could not be synchronized!\n",path);
+        exit(1);
+    }
+    munmap(map,size);
+    close(fd);
+}
+
+/*
+@brief Checks the header and the slots of a mapped table file, every length and offset that is used to reach a name must stay inside
+       the file and the counters of the header must match the slots
+@param map Mapped table file
+@param size Size of the file
+@return 1 if the file is valid, 0 otherwise
+*/
+int isValidPersistentFile(char* map, size_t size){
+    PERSISTENT_HEADER* header = (PERSISTENT_HEADER*) map;
+    PERSISTENT_SLOT* slots;
+    PERSISTENT_SLOT* slot;
+    char* keys;
+    uint64_t i, counter = 0, used = 0;
+    if(size < sizeof(PERSISTENT_HEADER) || memcmp(header->magic,PERSISTENT_MAGIC,sizeof(header->magic)) != 0 ||
+       (header->hashFunction != 1 && header->hashFunction != 2) || header->slotCount == 0 ||
+       (header->slotCount & (header->slotCount - 1)) != 0 || header->keyBytes > header->keyCapacity ||
+       header->slotCount > (size - sizeof(PERSISTENT_HEADER)) / sizeof(PERSISTENT_SLOT) ||
+       header->keyCapacity != size - sizeof(PERSISTENT_HEADER) - sizeof(PERSISTENT_SLOT)*header->slotCount){
+        return 0;
+    }
+    slots = (PERSISTENT_SLOT*) (map + sizeof(PERSISTENT_HEADER));
+    keys = map + sizeof(PERSISTENT_HEADER) + sizeof(PERSISTENT_SLOT)*header->slotCount;
+    for(i=0;i<header->slotCount;i++){
+        slot = &slots[i];
+        if(slot->length < EMPTY_SLOT || (slot->isDeleted != 0 && slot->isDeleted != 1)){
+            return 0;
+        }
+        if(slot->length == EMPTY_SLOT){
+            continue;
+        }
+        //Tombstones keep their names, so their names are checked too
+        if(slot->length < INLINE_NAME){
+            if(slot->name.inlined[slot->length] != '\0'){
+                return 0;
+            }
+        }else if(slot->name.offset > header->keyBytes || (uint64_t)slot->length + 1 > header->keyBytes - slot->name.offset ||
+                 keys[slot->name.offset + slot->length] != '\0'){
+            return 0;
+        }
+        used++;
+        if(slot->isDeleted == 0){
+            counter++;
+        }
+    }
+    return counter == header->counter && used == header->used;
+}
+
+/*
+@brief Maps the table file of a persistent table privately and checks its header and slots. Nothing is rehashed, the names are only
+       checked to stay inside the file. The hash function of the file is selected
+@param table Persistent table whose path is set
+@return
+*/
+void mapPersistentFile(PERSISTENT_TABLE* table){
+    struct stat status;
+    PERSISTENT_HEADER* header;
+    table->fd = open(table->path,O_RDWR);
+    if(table->fd < 0 || fstat(table->fd,&status) != 0){
+        printf("%s could not be opened!\n",table->path);
+        exit(1);
+    }
+    table->mapSize = (size_t)status.st_size;
+    if(table->mapSize < sizeof(PERSISTENT_HEADER)){
+        printf("%s is not a hash table file!\n",table->path);
+        exit(1);
+    }
+    table->map = (char*) mmap(NULL,table->mapSize,PROT_READ | PROT_WRITE,MAP_PRIVATE,table->fd,0);
+    if(table->map == MAP_FAILED){
+        printf("%s could not be mapped!\n",table->path);
+        exit(1);
+    }
+    header = (PERSISTENT_HEADER*) table->map;
+    if(!isValidPersistentFile(table->map,table->mapSize)){
+        printf("%s is not a hash table file!\n",table->path);
+        exit(1);
+    }
+    hashName = header->hashFunction == 2 ? calculateFnvHash : calculateFastHash;
+    table->header = header;
+    table->slots = (PERSISTENT_SLOT*) (table->map + sizeof(PERSISTENT_HEADER));
+    table->keys = table->map + sizeof(PERSISTENT_HEADER) + sizeof(PERSISTENT_SLOT)*header->slotCount;
+}
+
+/*
+@brief Opens the persistent table of a file, the file is created if it does not exist. Committed records of the write-ahead log
+       that were not checkpointed before a crash are written to the file first, a record that was not written completely is dropped
+@param path Path of the table file, its log is kept next to it with the extension .wal
+@param M Minimum number of slots of a new file
+@param loadFactor Maximum ratio of used slots
+@return Opened persistent table
+*/
+PERSISTENT_TABLE* openPersistentTable(char* path, int M, float loadFactor){
+    PERSISTENT_TABLE* table = (PERSISTENT_TABLE*) calloc(1,sizeof(PERSISTENT_TABLE));
+    char* walPath = (char*) malloc(strlen(path) + 5);
+    struct stat status;
+    char* records;
+    uint64_t slotCount = GROUP_SIZE;
+    int fd;
+    if(table == NULL || walPath == NULL){
+        printf("Memory allocation error!");
+        exit(1);
+    }
+    table->path = strdup(path);
+    table->loadFactor = loadFactor;
+    sprintf(walPath,"%s.wal",path);
+    if(stat(path,&status) != 0){
+        while(slotCount < (uint64_t)M){
+            slotCount *= 2;
+        }
+        writePersistentFile(path,NULL,slotCount,slotCount*INLINE_NAME);
+        syncDirectory(path);
+        table->isNew = 1;
+    }
+
+    table->walFd = open(walPath,O_RDWR | O_CREAT,0644);
+    if(table->walFd < 0 || fstat(table->walFd,&status) != 0){
+        printf("%s could not be opened!\n",walPath);
+        exit(1);
+    }
+    if(status.st_size > 0){
+        records = (char*) malloc(status.st_size);
+        fd = open(path,O_RDWR);
+        if(records == NULL || fd < 0){
+            printf("%s could not be recovered!\n",path);
+            exit(1);
+        }
+        if(pread(table->walFd,records,status.st_size,0) == status.st_size){
+            struct stat fileStatus;
+            fstat(fd,&fileStatus);
+            applyRecords(fd,records,status.st_size,(size_t)fileStatus.st_size);
+        }
+        if(fdatasync(fd) != 0 || ftruncate(table->walFd,0) != 0 || fdatasync(table->walFd) != 0){
+            printf("%s could not be recovered!\n",path);
+            exit(1);
+        }
+        close(fd);
+        free(records);
+    }
+    free(walPath);
+    mapPersistentFile(table);
+    return table;
+}
+
+/*
+@brief Writes all changes to the table file and closes it
+@param table Persistent table to be closed
+@return
+*/
+void closePersistentTable(PERSISTENT_TABLE* table){
+    commitPersistentTable(table);
+    checkpointPersistentTable(table);
+    munmap(table->map,table->mapSize);
+    close(table->fd);
+    close(table->walFd);
+    free(table->wal);
+    free(table->path);
+    free(table);
+}
+
+/*
+@brief Rebuilds the table file with the given sizes without tombstones. The new file is written next to the old one and renamed over it,
+       so a crash leaves either the old or the new file. The log is checkpointed first, so it is empty for the new file
+@param table Persistent table to be rebuilt
+@param slotCount Number of slots of the new file, a power of 2
+@param keyCapacity Size of the key area of the new file
+@return
+*/
+void rebuildPersistentTable(PERSISTENT_TABLE* table, uint64_t slotCount, uint64_t keyCapacity){
+    char* newPath = (char*) malloc(strlen(table->path) + 5);
+    if(newPath == NULL){
+        printf("Memory allocation error!");
+        exit(1);
+    }
+    sprintf(newPath,"%s.new",table->path);
+    commitPersistentTable(table);
+    checkpointPersistentTable(table);
+    writePersistentFile(newPath,table,slotCount,keyCapacity);
+    if(rename(newPath,table->path) != 0){
+        printf("%s could not be replaced!\n",table->path);
+        exit(1);
+    }
+    syncDirectory(table->path);
+    munmap(table->map,table->mapSize);
+    close(table->fd);
+    mapPersistentFile(table);
+    free(newPath);
+}
+
+/*
+@brief Finds the number of key bytes of the names of the persistent table that have not been deleted
+@param table Persistent table
+@return Number of bytes
+*/
+uint64_t liveKeyBytes(PERSISTENT_TABLE* table){
+    uint64_t i, bytes = 0;
+    for(i=0;i<table->header->slotCount;i++){
+        if(table->slots[i].length >= INLINE_NAME && table->slots[i].isDeleted == 0){
+            bytes += table->slots[i].length + 1;
+        }
+    }
+    return bytes;
+}
+
+/*
+@brief Finds the slot of the given name in the persistent table with linear probing
+@param table Persistent table to be searched
+@param username Name to be searched
+@param length Length of the name
+@param hash Hash value of the name
+@param mode Mode in which the program is run (1 = Normal Mode, 2 = Debug Mode)
+@param attempts Number of probed slots is written to it
+@return Index of the name in the persistent table (-1 = Not Found)
+*/
+int findInPersistentTable(PERSISTENT_TABLE* table, char* username, int length, uint64_t hash, int mode, int* attempts){
+    uint64_t mask = table->header->slotCount - 1;
+    uint64_t index = hash & mask;
+    PERSISTENT_SLOT* slot;
+    uint64_t i;
+    for(i=0;i<=mask;i++){
+        slot = &table->slots[index];
+        if(slot->length == EMPTY_SLOT){
+            break;
+        }
+        if(mode == 2){
+            printf("Index = %d -- i = %d\n",(int)index,(int)i);
+        }
+        if(slot->isDeleted == 0 && slot->hash == hash && slot->length == length &&
+           equalNames(persistentName(table,slot),username,length)){
+            *attempts = (int)i + 1;
+            return (int)index;
+        }
+        index = (index + 1) & mask;
+    }
+    *attempts = (int)i + 1;
+    return -1;
+}
+
+/*
+@brief Inserts a name whose hash value is known to the persistent table without printing. The file is rebuilt first if the name would
+       exceed the load factor or the key area. The changed bytes are logged in one record, which is committed by the caller
+@param table Persistent table to be inserted
+@param username Name to be inserted
+@param length Length of the name
+@param hash Hash value of the name
+@return Index of the name in the persistent table (-1 = The name is already in the table)
+*/
+int insertToPersistentTable(PERSISTENT_TABLE* table, char* username, int length, uint64_t hash){
+    uint64_t mask, index, slotCount, keyCapacity, live;
+    PERSISTENT_SLOT* slot;
+    int attempts;
+    if(findInPersistentTable(table,username,length,hash,1,&attempts) != -1){
+        return -1;
+    }
+    if(table->header->used + 1 > table->loadFactor*table->header->slotCount ||
+       (length >= INLINE_NAME && table->header->keyBytes + length + 1 > table->header->keyCapacity)){
+        //Tombstones and the key bytes of deleted names are dropped, the file grows if the live names need it
+        slotCount = table->header->slotCount;
+        if(table->header->counter + 1 > table->loadFactor*slotCount/2){
+            slotCount *= 2;
+        }
+        live = liveKeyBytes(table) + length + 1;
+        keyCapacity = table->header->keyCapacity*(slotCount/table->header->slotCount);
+        if(keyCapacity < 2*live){
+            keyCapacity = 2*live;
+        }
+        rebuildPersistentTable(table,slotCount,keyCapacity);
+    }
+
+    mask = table->header->slotCount - 1;
+    index = hash & mask;
+    while(table->slots[index].length != EMPTY_SLOT && table->slots[index].isDeleted == 0){
+        index = (index + 1) & mask;
+    }
+    slot = &table->slots[index];
+    beginRecord(table);
+    if(slot->length == EMPTY_SLOT){
+        table->header->used++;
+    }
+    slot->hash = hash;
+    slot->length = length;
+    slot->isDeleted = 0;
+    if(length < INLINE_NAME){
+        memcpy(slot->name.inlined,username,length + 1);
+    }else{
+        slot->name.offset = table->header->keyBytes;
+        memcpy(table->keys + table->header->keyBytes,username,length + 1);
+        logChange(table,table->keys + table->header->keyBytes,length + 1);
+        table->header->keyBytes += length + 1;
+    }
+    table->header->counter++;
+    logChange(table,slot,sizeof(PERSISTENT_SLOT));
+    logChange(table,table->header,sizeof(PERSISTENT_HEADER));
+    endRecord(table);
+    return (int)index;
+}
+
+/*
+@brief Removes a name whose hash value is known from the persistent table without printing, its slot becomes a tombstone.
+       The changed bytes are logged in one record, which is committed by the caller
+@param table Persistent table to be removed from
+@param username Name to be removed
+@param length Length of the name
+@param hash Hash value of the name
+@return Index of the removed name (-1 = Not Found)
+*/
+int removeFromPersistentTable(PERSISTENT_TABLE* table, char* username, int length, uint64_t hash){
+    int attempts;
+    int index = findInPersistentTable(table,username,length,hash,1,&attempts);
+    if(index == -1){
+        return -1;
+    }
+    beginRecord(table);
+    table->slots[index].isDeleted = 1;
+    table->header->counter--;
+    logChange(table,&table->slots[index],sizeof(PERSISTENT_SLOT));
+    logChange(table,table->header,sizeof(PERSISTENT_HEADER));
+    endRecord(table);
+    return index;
+}
+
+/*
+@brief Prints the given persistent table
+@param table Persistent table to be printed
+@return
+*/
+void printPersistentTable(PERSISTENT_TABLE* table){
+    printf("\n");
+    uint64_t i;
+    for(i=0;i<table->header->slotCount;i++){
+        printf("%d: %s (%d)\n",(int)i,persistentName(table,&table->slots[i]),table->slots[i].length < 0 ? 0 : table->slots[i].isDeleted);
+    }
+}
+
+/*
+@brief Creates an empty slot array for the concurrent table
+@param M Minimum number of slots
+@return Created slot array
+*/
+CONCURRENT_SLOTS* createConcurrentSlots(int M){
+    CONCURRENT_SLOTS* slots = (CONCURRENT_SLOTS*) malloc(sizeof(CONCURRENT_SLOTS));
+    int i;
+    if(slots == NULL){
+        printf("Memory allocation error!");
+        exit(1);
+    }
+    slots->size = GROUP_SIZE;
+    while(slots->size < M){
+        slots->size *= 2;
+    }
+    slots->names = (_Atomic(CONCURRENT_NAME*)*) malloc(sizeof(_Atomic(CONCURRENT_NAME*))*slots->size);
+    if(slots->names == NULL){
+        printf("Memory allocation error!");
+        exit(1);
+    }
+    for(i=0;i<slots->size;i++){
+        atomic_init(&slots->names[i],NULL);
+    }
+    atomic_init(&slots->used,0);
+    return slots;
+}
+
+/*
+@brief Frees a slot array of the concurrent table without its names, they are moved to the next slot array or retired one by one
+@param block Slot array to be freed
+@return
+*/
+void freeConcurrentSlots(void* block){
+    CONCURRENT_SLOTS* slots = (CONCURRENT_SLOTS*) block;
+    free(slots->names);
+    free(slots);
+}
+
+/*
+@brief Creates an empty concurrent table
+@param M Minimum number of slots
+@param loadFactor Maximum ratio of used slots
+@return Created concurrent table
+*/
+CONCURRENT_TABLE* createConcurrentTable(int M, float loadFactor){
+    CONCURRENT_TABLE* table = (CONCURRENT_TABLE*) aligned_alloc(64,sizeof(CONCURRENT_TABLE));
+    int i;
+    if(table == NULL){
+        printf("Memory allocation error!");
+        exit(1);
+    }
+    atomic_init(&table->slots,createConcurrentSlots(M));
+    for(i=0;i<STRIPE_COUNT;i++){
+        pthread_mutex_init(&table->locks[i],NULL);
+    }
+    atomic_init(&table->counter,0);
+    table->loadFactor = loadFactor;
+    atomic_init(&table->epoch,0);
+    for(i=0;i<MAX_THREADS;i++){
+        atomic_init(&table->threads[i].epoch,0);
+        atomic_init(&table->threads[i].active,0);
+        table->threads[i].lastEpoch = 0;
+        table->threads[i].retired[0] = NULL;
+        table->threads[i].retired[1] = NULL;
+        table->threads[i].retired[2] = NULL;
+        table->threads[i].retiredCount = 0;
+    }
+    return table;
+}
+
+/*
+@brief Frees the retired blocks of a list
+@param list List of retired blocks, it becomes empty
+@return Number of freed blocks
+*/
+int releaseBlocks(RETIRED_BLOCK** list){
+    RETIRED_BLOCK* next;
+    int count = 0;
+    while(*list != NULL){
+        next = (*list)->next;
+        (*list)->release((*list)->block);
+        free(*list);
+        *list = next;
+        count++;
+    }
+    return count;
+}
+
+/*
+@brief Frees the concurrent table, its names and all retired blocks. No thread may use the table anymore
+@param table Concurrent table to be freed
+@return
+*/
+void freeConcurrentTable(CONCURRENT_TABLE* table){
+    CONCURRENT_SLOTS* slots = atomic_load(&table->slots);
+    CONCURRENT_NAME* name;
+    int i;
+    for(i=0;i<slots->size;i++){
+        name = atomic_load(&slots->names[i]);
+        if(name != NULL && name != &removedName){
+            free(name);
+        }
+    }
+    freeConcurrentSlots(slots);
+    for(i=0;i<MAX_THREADS;i++){
+        releaseBlocks(&table->threads[i].retired[0]);
+        releaseBlocks(&table->threads[i].retired[1]);
+        releaseBlocks(&table->threads[i].retired[2]);
+    }
+    for(i=0;i<STRIPE_COUNT;i++){
+        pthread_mutex_destroy(&table->locks[i]);
+    }
+    free(table);
+}
+
+/*
+@brief Marks the thread as active in the current global epoch. The epoch is read again after it is published, so an active thread
+       is never behind the global epoch by more than one. Blocks that the thread retired 3 epochs ago are freed
+@param table Concurrent table to be used
+@param thread Index of the thread (0 <= thread < MAX_THREADS)
+@return
+*/
+void enterEpoch(CONCURRENT_TABLE* table, int thread){
+    EPOCH_THREAD* state = &table->threads[thread];
+    unsigned long epoch;
+    atomic_store(&state->active,1);
+    do{
+        epoch = atomic_load(&table->epoch);
+        atomic_store(&state->epoch,epoch);
+    }while(epoch != atomic_load(&table->epoch));
+    if(epoch != state->lastEpoch){
+        state->retiredCount -= releaseBlocks(&state->retired[epoch % 3]);
+        state->lastEpoch = epoch;
+    }
+}
+
+/*
+@brief Marks the thread as inactive, it does not read the table until it enters an epoch again
+@param table Concurrent table that was used
+@param thread Index of the thread
+@return
+*/
+void exitEpoch(CONCURRENT_TABLE* table, int thread){
+    atomic_store_explicit(&table->threads[thread].active,0,memory_order_release);
+}
+
+/*
+@brief Advances the global epoch if every active thread has entered the current one
+@param table Concurrent table
+@return
+*/
+void advanceEpoch(CONCURRENT_TABLE* table){
+    unsigned long epoch = atomic_load(&table->epoch);
+    int i;
+    for(i=0;i<MAX_THREADS;i++){
+        if(atomic_load(&table->threads[i].active) && atomic_load(&table->threads[i].epoch) != epoch){
+            return;
+        }
+    }
+    atomic_compare_exchange_strong(&table->epoch,&epoch,epoch + 1);
+}
+
+/*
+@brief Retires a block that was removed from the table, it is freed when no thread can read it anymore. The thread must be in an epoch
+@param table Concurrent table
+@param thread Index of the thread
+@param block Block to be freed
+@param release Function that frees the block
+@return
+*/
+void retireBlock(CONCURRENT_TABLE* table, int thread, void* block, void (*release)(void* block)){
+    EPOCH_THREAD* state = &table->threads[thread];
+    RETIRED_BLOCK* retired = (RETIRED_BLOCK*) malloc(sizeof(RETIRED_BLOCK));
+    if(retired == NULL){
+        printf("Memory allocation error!");
+        exit(1);
+    }
+    retired->block = block;
+    retired->release = release;
+    retired->next = state->retired[state->lastEpoch % 3];
+    state->retired[state->lastEpoch % 3] = retired;
+    state->retiredCount++;
+    if(state->retiredCount >= RETIRE_LIMIT){
+        advanceEpoch(table);
+    }
+}
+
+/*
+@brief Finds the slot of the given name in a slot array of the concurrent table with linear probing, without locks
+@param slots Slot array to be searched
+@param username Name to be searched
+@param length Length of the name
+@param hash Hash value of the name
+@return Index of the name in the slot array (-1 = Not Found)
+*/
+int findInConcurrentSlots(CONCURRENT_SLOTS* slots, char* username, int length, uint64_t hash){
+    int mask = slots->size - 1;
+    int index = (int)(hash & mask);
+    int i;
+    CONCURRENT_NAME* name;
+    for(i=0;i<slots->size;i++){
+        name = atomic_load_explicit(&slots->names[index],memory_order_acquire);
+        if(name == NULL){
+            return -1;
+        }
+        if(name != &removedName && name->hash == hash && name->length == length && equalNames(name->username,username,length)){
+            return index;
+        }
+        index = (index + 1) & mask;
+    }
+    return -1;
+}
+
+/*
+@brief Searches the given name in the concurrent table without taking a lock
+@param table Concurrent table to be searched
+@param username Name to be searched
+@param thread Index of the thread
+@return Index of the name in the current slot array (-1 = Not Found)
+*/
+int searchInConcurrentTable(CONCURRENT_TABLE* table, char* username, int thread){
+    int length = (int)strlen(username);
+    uint64_t hash = hashName(username,length);
+    int index;
+    enterEpoch(table,thread);
+    index = findInConcurrentSlots(atomic_load_explicit(&table->slots,memory_order_acquire),username,length,hash);
+    exitEpoch(table,thread);
+    return index;
+}
+
+/*
+@brief Builds a new slot array without tombstones and retires the old one. All stripes are locked, so no writer uses the old array,
+       searches that still read it see the same names. The table grows to twice its size if more than half of the allowed names are alive
+@param table Concurrent table to be rebuilt
+@param thread Index of the thread, it must be in an epoch and must not hold a stripe lock
+@param force 1 to rebuild with the same size even if the load factor is not exceeded
+@return
+*/
+void rebuildConcurrentTable(CONCURRENT_TABLE* table, int thread, int force){
+    CONCURRENT_SLOTS* old;
+    CONCURRENT_SLOTS* slots;
+    CONCURRENT_NAME* name;
+    int i, index, size, used = 0;
+    for(i=0;i<STRIPE_COUNT;i++){
+        pthread_mutex_lock(&table->locks[i]);
+    }
+    old = atomic_load(&table->slots);
+    if(force || atomic_load(&old->used) + 1 > table->loadFactor*old->size){
+        size = !force && atomic_load(&table->counter) > table->loadFactor*old->size/2 ? 2*old->size : old->size;
+        slots = createConcurrentSlots(size);
+        for(i=0;i<old->size;i++){
+            name = atomic_load_explicit(&old->names[i],memory_order_relaxed);
+            if(name != NULL && name != &removedName){
+                index = (int)(name->hash & (size - 1));
+                while(atomic_load_explicit(&slots->names[index],memory_order_relaxed) != NULL){
+                    index = (index + 1) & (size - 1);
+                }
+                atomic_store_explicit(&slots->names[index],name,memory_order_relaxed);
+                used++;
+            }
+        }
+        atomic_store(&slots->used,used);
+        atomic_store_explicit(&table->slots,slots,memory_order_release);
+        retireBlock(table,thread,old,freeConcurrentSlots);
+    }
+    for(i=STRIPE_COUNT-1;i>=0;i--){
+        pthread_mutex_unlock(&table->locks[i]);
+    }
+}
+
+/*
+@brief Inserts the given name to the concurrent table. An empty slot is reserved before the probe, so concurrent insertions can not
+       exceed the load factor and every probe sequence ends at an empty slot. The name takes the first empty slot or tombstone it can
+       claim with compare-and-swap
+@param table Concurrent table to be inserted
+@param username Name to be inserted
+@param thread Index of the thread
+@return Index of the name in the current slot array (-1 = The name is already in the table)
+*/
+int insertToConcurrentTable(CONCURRENT_TABLE* table, char* username, int thread){
+    int length = (int)strlen(username);
+    uint64_t hash = hashName(username,length);
+    pthread_mutex_t* lock = &table->locks[(hash >> 32) & (STRIPE_COUNT - 1)];
+    CONCURRENT_SLOTS* slots;
+    CONCURRENT_NAME* name;
+    CONCURRENT_NAME* current;
+    int index, mask;
+    enterEpoch(table,thread);
+    while(1){
+        pthread_mutex_lock(lock);
+        slots = atomic_load_explicit(&table->slots,memory_order_acquire);
+        if(findInConcurrentSlots(slots,username,length,hash) != -1){
+            pthread_mutex_unlock(lock);
+            exitEpoch(table,thread);
+            return -1;
+        }
+        if(atomic_fetch_add(&slots->used,1) + 1 <= table->loadFactor*slots->size){
+            break;
+        }
+        atomic_fetch_sub(&slots->used,1);
+        pthread_mutex_unlock(lock);
+        rebuildConcurrentTable(table,thread,0);
+    }
+
+    name = (CONCURRENT_NAME*) malloc(sizeof(CONCURRENT_NAME) + length + 1);
+    if(name == NULL){
+        printf("Memory allocation error!");
+        exit(1);
+    }
+    name->hash = hash;
+    name->length = length;
+    memcpy(name->username,username,length + 1);
+    mask = slots->size - 1;
+    index = (int)(hash & mask);
+    while(1){
+        current = atomic_load_explicit(&slots->names[index],memory_order_relaxed);
+        if((current == NULL || current == &removedName) &&
+           atomic_compare_exchange_strong_explicit(&slots->names[index],&current,name,memory_order_release,memory_order_relaxed)){
+            break;
+        }
+        index = (index + 1) & mask;
+    }
+    if(current == &removedName){
+        //A tombstone was reused, the reserved empty slot is given back
+        atomic_fetch_sub(&slots->used,1);
+    }
+    atomic_fetch_add(&table->counter,1);
+    pthread_mutex_unlock(lock);
+    exitEpoch(table,thread);
+    return index;
+}
+
+/*
+@brief Removes the given name from the concurrent table. Its slot becomes a tombstone and the name is retired, searches that have
+       already read it can still compare it
+@param table Concurrent table to be removed from
+@param username Name to be removed
+@param thread Index of the thread
+@return Index of the removed name in the current slot array (-1 = Not Found)
+*/
+int removeFromConcurrentTable(CONCURRENT_TABLE* table, char* username, int thread){
+    int length = (int)strlen(username);
+    uint64_t hash = hashName(username,length);
+    pthread_mutex_t* lock = &table->locks[(hash >> 32) & (STRIPE_COUNT - 1)];
+    CONCURRENT_SLOTS* slots;
+    CONCURRENT_NAME* name = NULL;
+    int index;
+    enterEpoch(table,thread);
+    pthread_mutex_lock(lock);
+    slots = atomic_load_explicit(&table->slots,memory_order_acquire);
+    index = findInConcurrentSlots(slots,username,length,hash);
+    if(index != -1){
+        name = atomic_load_explicit(&slots->names[index],memory_order_relaxed);
+        atomic_store_explicit(&slots->names[index],&removedName,memory_order_release);
+        atomic_fetch_sub(&table->counter,1);
+    }
+    pthread_mutex_unlock(lock);
+    if(name != NULL){
+        retireBlock(table,thread,name,free);
+    }
+    exitEpoch(table,thread);
+    return index;
+}
+
+/*
+@brief Prints the given concurrent table, no other thread may write to it
+@param table Concurrent table to be printed
+@return
+*/
+void printConcurrentTable(CONCURRENT_TABLE* table){
+    CONCURRENT_SLOTS* slots = atomic_load(&table->slots);
+    CONCURRENT_NAME* name;
+    int i;
+    printf("\n");
+    for(i=0;i<slots->size;i++){
+        name = atomic_load(&slots->names[i]);
+        if(name == NULL || name == &removedName){
+            printf("%d: (null) (%d)\n",i,name == &removedName);
+        }else{
+            printf("%d: %s (0)\n",i,name->username);
+        }
+    }
+}
+
+/*
+@brief Struct for the arguments of a benchmark thread
+*/
+typedef struct BENCHMARK_WORKER{
+    CONCURRENT_TABLE* table;
+    char** names;
+    int nameCount;
+    int thread;
+    int threadCount;
+}BENCHMARK_WORKER;
+
+/*
+@brief Finds the current time
+@return Seconds from an arbitrary point
+*/
+double getTime(){
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC,&now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/*
+@brief Runs the operations of a benchmark thread: BENCHMARK_READS searches of random names for every removal and re-insertion.
+       A thread only writes the names whose index has its remainder, so every name is in the table when the threads finish
+@param argument BENCHMARK_WORKER of the thread
+@return NULL
+*/
+void* runBenchmarkWorker(void* argument){
+    BENCHMARK_WORKER* worker = (BENCHMARK_WORKER*) argument;
+    uint64_t random = 0x9E3779B97F4A7C15ULL * (worker->thread + 1);
+    int i, index;
+    for(i=0;i<BENCHMARK_OPERATIONS;i++){
+        random ^= random << 13;
+        random ^= random >> 7;
+        random ^= random << 17;
+        index = (int)((random >> 16) % worker->nameCount);
+        if((random & 0xFFFF) % (BENCHMARK_READS + 1) != 0){
+            searchInConcurrentTable(worker->table,worker->names[index],worker->thread);
+        }else{
+            index = index - index % worker->threadCount + worker->thread;
+            if(index >= worker->nameCount){
+                index -= worker->threadCount;
+            }
+            if(index >= 0){
+                removeFromConcurrentTable(worker->table,worker->names[index],worker->thread);
+                insertToConcurrentTable(worker->table,worker->names[index],worker->thread);
+            }
+        }
+    }
+    return NULL;
+}
+
+/*
+@brief Measures the throughput of the concurrent table with 1 to MAX_THREADS threads and checks that no name was lost
+@param nameCount Number of names in the table
+@param loadFactor Maximum ratio of used slots
+@return
+*/
+void runConcurrentBenchmark(int nameCount, float loadFactor){
+    char** names = (char**) malloc(sizeof(char*)*nameCount);
+    pthread_t threads[MAX_THREADS];
+    BENCHMARK_WORKER workers[MAX_THREADS];
+    CONCURRENT_TABLE* table;
+    double startTime, elapsed, baseRate = 0;
+    int started[MAX_THREADS];
+    int i, threadCount, startedCount;
+    if(names == NULL){
+        printf("Memory allocation error!");
+        exit(1);
+    }
+    for(i=0;i<nameCount;i++){
+        names[i] = (char*) malloc(sizeof(char)*32);
+        if(names[i] == NULL){
+            printf("Memory allocation error!");
+            exit(1);
+        }
+        sprintf(names[i],"user%d@example.com",i);
+    }
+
+    printf("Threads\tOperations/s\tSpeedup\n");
+    for(threadCount=1;threadCount<=MAX_THREADS;threadCount*=2){
+        table = createConcurrentTable(GROUP_SIZE,loadFactor);
+        for(i=0;i<nameCount;i++){
+            insertToConcurrentTable(table,names[i],0);
+        }
+        startTime = getTime();
+        startedCount = 0;
+        for(i=0;i<threadCount;i++){
+            workers[i].table = table;
+            workers[i].names = names;
+            workers[i].nameCount = nameCount;
+            workers[i].thread = i;
+            workers[i].threadCount = threadCount;
+            started[i] = pthread_create(&threads[i],NULL,runBenchmarkWorker,&workers[i]) == 0;
+            startedCount += started[i];
+        }
+        for(i=0;i<threadCount;i++){
+            if(started[i]){
+                pthread_join(threads[i],NULL);
+            }
+        }
+        elapsed = getTime() - startTime;
+        //Only the operations of the threads that could be started are counted, the names of the others stay in the table
+        if(startedCount == 0){
+            printf("%d\tno thread could be started\n",threadCount);
+        }else{
+            if(baseRate == 0){
+                baseRate = (double)startedCount*BENCHMARK_OPERATIONS/elapsed;
+            }
+            printf("%d\t%.0f\t%.2f",startedCount,(double)startedCount*BENCHMARK_OPERATIONS/elapsed,
+                   (double)startedCount*BENCHMARK_OPERATIONS/elapsed/baseRate);
+            if(startedCount < threadCount){
+                printf("\t(%d of %d threads could be started)",startedCount,threadCount);
+            }
+            printf("\n");
+        }
+
+        for(i=0;i<nameCount;i++){
+            if(searchInConcurrentTable(table,names[i],0) == -1){
+                printf("%s was lost by the concurrent table!\n",names[i]);
+                exit(1);
+            }
+        }
+        freeConcurrentTable(table);
+    }
+    for(i=0;i<nameCount;i++){
+        free(names[i]);
+    }
+    free(names);
+}
+
+/*
+@brief Creates an empty Hash Table of the given engine
+@param engine ENGINE_DOUBLE, ENGINE_SWISS, ENGINE_CONCURRENT, ENGINE_ROBIN or ENGINE_PERSISTENT, whose file is opened by the caller
+@param M Initial size of the Hash Table, double hashing uses the next prime, the other engines the next multiple of 16 that is a power of 2
+@param loadFactor Maximum ratio of used slots
+@return Created Hash Table
+*/
+HASH_TABLE createHashTable(int engine, int M, float loadFactor){
+    HASH_TABLE table;
+    int i;
+    table.engine = engine;
+    table.arena = createArena();
+    table.M = nextPrime(M);
+    table.counter = 0;
+    table.used = 0;
+    table.loadFactor = loadFactor;
+    table.hashTable = NULL;
+    table.swiss = NULL;
+    table.concurrent = NULL;
+    table.oldHashTable = NULL;
+    table.oldM = 0;
+    table.oldSwiss = NULL;
+    table.robin = NULL;
+    table.oldRobin = NULL;
+    table.persistent = NULL;
+    table.migrated = 0;
+    if(engine == ENGINE_SWISS){
+        table.swiss = createSwissTable(M,table.arena);
+        return table;
+    }
+    if(engine == ENGINE_CONCURRENT){
+        table.concurrent = createConcurrentTable(M,loadFactor);
+        return table;
+    }
+    if(engine == ENGINE_ROBIN){
+        table.robin = createRobinTable(M,table.arena);
+        return table;
+    }
+    if(engine == ENGINE_PERSISTENT){
+        return table;
+    }
+    table.hashTable = (HASH_ITEM*) malloc(sizeof(HASH_ITEM)*table.M);
+    if(table.hashTable == NULL){
+        printf("Memory allocation error!");
+        exit(1);
+    }
+    for(i=0;i<table.M;i++){
+        table.hashTable[i].length = EMPTY_SLOT;
+        table.hashTable[i].isDeleted = 0;
+        table.hashTable[i].hash = 0;
+    }
+    return table;
+}
+
+/*
+@brief Checks whether the Hash Table is being resized
+@param table Hash Table
+@return 1 if it has an old table whose slots are not all moved, 0 otherwise
+*/
+int isResizing(HASH_TABLE* table){
+    return table->oldHashTable != NULL || table->oldSwiss != NULL || table->oldRobin != NULL;
+}
+
+/*
+@brief Finds the number of slots of the old table of a resize
+@param table Hash Table that is resized
+@return Number of slots of the old table
+*/
+int oldSlotCount(HASH_TABLE* table){
+    if(table->engine == ENGINE_SWISS){
+        return table->oldSwiss->groupCount*GROUP_SIZE;
+    }
+    if(table->engine == ENGINE_ROBIN){
+        return table->oldRobin->size;
+    }
+    return table->oldM;
+}
+
+/*
+@brief Moves a name from a slot of the old table to the new table. The old slot becomes a tombstone, so the probe sequences of the
+       old table that pass through it are not broken
+@param table Hash Table that is resized
+@param index Index of the slot in the old table
+@return
+*/
+void moveOldSlot(HASH_TABLE* table, int index){
+    if(table->engine == ENGINE_ROBIN){
+        //The moved slot keeps its hash value, so the distances that searches of the old table compare stay valid
+        placeInRobinTable(table->robin,table->oldRobin->slots[index]);
+        table->oldRobin->slots[index].length = MOVED_SLOT;
+        table->oldRobin->counter--;
+        return;
+    }
+    if(table->engine == ENGINE_SWISS){
+        SWISS_TABLE* old = table->oldSwiss;
+        placeInSwissTable(table->swiss,old->slots[index]);
+        old->slots[index].length = EMPTY_SLOT;
+        old->control[index] = CONTROL_DELETED;
+        old->counter--;
+        old->deleted++;
+        return;
+    }
+    placeInHashTable(table->hashTable,table->M,table->oldHashTable[index],&table->used,table->arena);
+    table->oldHashTable[index].length = MOVED_SLOT;
+    table->oldHashTable[index].isDeleted = 1;
+}
+
+/*
+@brief Moves the next slots of the old table to the new table and frees the old table when all of its slots are moved. The key arena
+       is compacted then if the dropped names take more bytes than the live ones
+@param table Hash Table that is resized
+@param count Number of old slots to be moved
+@return
+*/
+void migrateSlots(HASH_TABLE* table, int count){
+    int i, oldSize;
+    if(!isResizing(table)){
+        return;
+    }
+    oldSize = oldSlotCount(table);
+    for(i=0;i<count && table->migrated<oldSize;i++){
+        if(table->engine == ENGINE_SWISS && table->oldSwiss->control[table->migrated] >= 0){
+            moveOldSlot(table,table->migrated);
+        }else if(table->engine == ENGINE_DOUBLE && table->oldHashTable[table->migrated].length != EMPTY_SLOT &&
+                 table->oldHashTable[table->migrated].isDeleted == 0){
+            moveOldSlot(table,table->migrated);
+        }else if(table->engine == ENGINE_ROBIN && table->oldRobin->slots[table->migrated].length >= 0){
+            moveOldSlot(table,table->migrated);
+        }
+        table->migrated++;
+    }
+    if(table->migrated < oldSize){
+        return;
+    }
+    if(table->engine == ENGINE_ROBIN){
+        freeRobinTable(table->oldRobin);
+        table->oldRobin = NULL;
+        if(table->arena->garbage > table->arena->live){
+            compactArena(table->robin->slots,table->robin->size,table->arena);
+        }
+        return;
+    }
+    if(table->engine == ENGINE_SWISS){
+        freeSwissTable(table->oldSwiss);
+        table->oldSwiss = NULL;
+        if(table->arena->garbage > table->arena->live){
+            compactArena(table->swiss->slots,table->swiss->groupCount*GROUP_SIZE,table->arena);
+        }
+        return;
+    }
+    for(i=0;i<table->oldM;i++){
+        //Names of the tombstones that were not moved are dropped, moved slots have no name
+        if(table->oldHashTable[i].isDeleted == 1){
+            dropItemName(&table->oldHashTable[i],table->arena);
+        }
+    }
+    free(table->oldHashTable);
+    table->oldHashTable = NULL;
+    if(table->arena->garbage > table->arena->live){
+        compactArena(table->hashTable,table->M,table->arena);
+    }
+}
+
+/*
+@brief Checks whether one more name would make the used slots of the Hash Table exceed its load factor
+@param table Hash Table to be checked
+@return 1 if the table has to be resized before the next insertion, 0 otherwise
+*/
+int isOverloaded(HASH_TABLE* table){
+    if(table->engine == ENGINE_CONCURRENT || table->engine == ENGINE_PERSISTENT){
+        //The concurrent and the persistent tables are rebuilt by their own insertions
+        return 0;
+    }
+    if(table->engine == ENGINE_SWISS){
+        return table->swiss->counter + table->swiss->deleted + 1 > table->loadFactor*table->swiss->groupCount*GROUP_SIZE;
+    }
+    if(table->engine == ENGINE_ROBIN){
+        return table->robin->counter + 1 > table->loadFactor*table->robin->size;
+    }
+    return table->used + 1 > table->loadFactor*table->M;
+}
+
+/*
+@brief Moves all remaining slots of the old table if the Hash Table is being resized
+@param table Hash Table
+@return
+*/
+void finishResize(HASH_TABLE* table){
+    if(isResizing(table)){
+        migrateSlots(table,oldSlotCount(table));
+    }
+}
+
+/*
+@brief Creates the new table of a resize, the slots of the current table are moved to it in the next operations.
+       The Hash Table must not be resized already
+@param table Hash Table to be resized
+@param newM Size of the new table, double hashing needs a prime and the other engines a multiple of 16
+@param mode Mode in which the program is run (1 = Normal Mode, 2 = Debug Mode)
+@return
+*/
+void beginResize(HASH_TABLE* table, int newM, int mode){
+    int i;
+    if(table->engine == ENGINE_ROBIN){
+        if(mode == 2){
+            printf("\nResizing the table from %d to %d slots\n",table->robin->size,newM);
+        }
+        table->oldRobin = table->robin;
+        table->robin = createRobinTable(newM,table->arena);
+        table->migrated = 0;
+        return;
+    }
+    if(table->engine == ENGINE_SWISS){
+        if(mode == 2){
+            printf("\nResizing the table from %d to %d slots\n",table->swiss->groupCount*GROUP_SIZE,newM);
+        }
+        table->oldSwiss = table->swiss;
+        table->swiss = createSwissTable(newM,table->arena);
+        table->migrated = 0;
+        return;
+    }
+
+    if(mode == 2){
+        printf("\nResizing the table from %d to %d slots\n",table->M,newM);
+    }
+    table->oldHashTable = table->hashTable;
+    table->oldM = table->M;
+    table->hashTable = (HASH_ITEM*) malloc(sizeof(HASH_ITEM)*newM);
+    if(table->hashTable == NULL){
+        printf("Memory allocation error!");
+        exit(1);
+    }
+    for(i=0;i<newM;i++){
+        table->hashTable[i].length = EMPTY_SLOT;
+        table->hashTable[i].isDeleted = 0;
+        table->hashTable[i].hash = 0;
+    }
+    table->M = newM;
+    table->used = 0;
+    table->migrated = 0;
+}
+
+/*
+@brief Starts to resize the Hash Table if one more name would exceed the load factor, so the table never fills up and every probe
+       sequence ends at an empty slot. The table grows to twice its size if more than half of the allowed names are alive, otherwise
+       it keeps its size and only the tombstones are dropped. A migration that is still running is finished first
+@param table Hash Table to be resized
+@param mode Mode in which the program is run (1 = Normal Mode, 2 = Debug Mode)
+@return
+*/
+void startResize(HASH_TABLE* table, int mode){
+    int slotCount;
+    if(!isOverloaded(table)){
+        return;
+    }
+    finishResize(table);
+    if(table->engine == ENGINE_ROBIN){
+        //Robin Hood Table has no tombstones, so it is only resized to grow
+        beginResize(table,2*table->robin->size,mode);
+        return;
+    }
+    if(table->engine == ENGINE_SWISS){
+        slotCount = table->swiss->groupCount*GROUP_SIZE;
+        beginResize(table,table->swiss->counter > table->loadFactor*slotCount/2 ? 2*slotCount : slotCount,mode);
+        return;
+    }
+    beginResize(table,table->counter > table->loadFactor*table->M/2 ? nextPrime(2*table->M) : table->M,mode);
+}
+
+/*
+@brief Moves the given name to the new table if the Hash Table is resized and the name is still in the old table
+@param table Hash Table that is used
+@param username Name to be moved
+@return
+*/
+void promoteName(HASH_TABLE* table, char* username){
+    int index, attempts, length;
+    if(!isResizing(table)){
+        return;
+    }
+    length = (int)strlen(username);
+    if(table->engine == ENGINE_ROBIN){
+        index = findInRobinTable(table->oldRobin,username,length,hashName(username,length),1,&attempts);
+    }else if(table->engine == ENGINE_SWISS){
+        index = findInSwissTable(table->oldSwiss,username,length,hashName(username,length),1,&attempts);
+    }else{
+        index = searchInHashTable(table->oldHashTable,table->oldM,username,1);
+    }
+    if(index != -1){
+        moveOldSlot(table,index);
+    }
+}
+
+/*
+@brief Prepares the Hash Table for an operation on a name while it is resized: the name is moved to the new table if it is still in the
+       old table, so the operation only has to look at the new table, then the next MIGRATION_STEP old slots are moved
+@param table Hash Table that is used
+@param username Name of the operation
+@return
+*/
+void stepResize(HASH_TABLE* table, char* username){
+    if(!isResizing(table)){
+        return;
+    }
+    promoteName(table,username);
+    migrateSlots(table,MIGRATION_STEP);
+}
+
+/*
+@brief Inserts the given name to the Hash Table with its engine, the table is resized first when the name would exceed its load factor
+@param table Hash Table to be inserted
+@param username Name to be inserted
+@param mode Mode in which the program is run (1 = Normal Mode, 2 = Debug Mode)
+@return
+*/
+void insertName(HASH_TABLE* table, char* username, int mode){
+    int index;
+    if(table->engine == ENGINE_CONCURRENT){
+        index = insertToConcurrentTable(table->concurrent,username,0);
+        if(index == -1){
+            printf("%s is already in the table!\n",username);
+        }else{
+            printf("%s was inserted to [%d]\n",username,index);
+        }
+        return;
+    }
+    if(table->engine == ENGINE_PERSISTENT){
+        if(mode == 2){
+            printf("Inserting %s\n",username);
+        }
+        int length = (int)strlen(username);
+        index = insertToPersistentTable(table->persistent,username,length,hashName(username,length));
+        commitPersistentTable(table->persistent);
+        if(index == -1){
+            printf("%s is already in the table!\n",username);
+        }else{
+            printf("%s was inserted to [%d]\n",username,index);
+        }
+        return;
+    }
+    stepResize(table,username);
+    startResize(table,mode);
+    //A resize that has just started moved the name to its old table, it is checked in the new table like the others
+    promoteName(table,username);
+    if(table->engine == ENGINE_ROBIN){
+        insertToRobinTable(table->robin,username,mode);
+    }else if(table->engine == ENGINE_SWISS){
+        insertToSwissTable(table->swiss,username,mode);
+    }else{
+        insertToHashTable(table->hashTable,table->M,username,mode,&table->counter,&table->used,table->arena);
+    }
+}
+
+/*
+@brief Searches the given name in the Hash Table with its engine
+@param table Hash Table to be searched
+@param username Name to be searched
+@param mode Mode in which the program is run (1 = Normal Mode, 2 = Debug Mode)
+@return Index of the name in the Hash Table (-1 = Not Found)
+*/
+int searchName(HASH_TABLE* table, char* username, int mode){
+    if(table->engine == ENGINE_CONCURRENT){
+        return searchInConcurrentTable(table->concurrent,username,0);
+    }
+    if(table->engine == ENGINE_PERSISTENT){
+        int attempts, length = (int)strlen(username);
+        return findInPersistentTable(table->persistent,username,length,hashName(username,length),mode,&attempts);
+    }
+    stepResize(table,username);
+    if(table->engine == ENGINE_ROBIN){
+        return searchInRobinTable(table->robin,username,mode);
+    }
+    if(table->engine == ENGINE_SWISS){
+        return searchInSwissTable(table->swiss,username,mode);
+    }
+    return searchInHashTable(table->hashTable,table->M,username,mode);
+}
+
+/*
+@brief Removes the given name from the Hash Table with its engine
+@param table Hash Table to be removed from
+@param username Name to be removed
+@param mode Mode in which the program is run (1 = Normal Mode, 2 = Debug Mode)
+@return
+*/
+void removeName(HASH_TABLE* table, char* username, int mode){
+    int index;
+    if(table->engine == ENGINE_CONCURRENT){
+        index = removeFromConcurrentTable(table->concurrent,username,0);
+        if(index == -1){
+            printf("%s was not found in the table!\n",username);
+        }else{
+            printf("%s was removed from [%d]\n",username,index);
+        }
+        return;
+    }
+    if(table->engine == ENGINE_PERSISTENT){
+        int length = (int)strlen(username);
+        index = removeFromPersistentTable(table->persistent,username,length,hashName(username,length));
+        commitPersistentTable(table->persistent);
+        if(index == -1){
+            printf("%s was not found in the table!\n",username);
+        }else{
+            printf("%s was removed from [%d]\n",username,index);
+        }
+        return;
+    }
+    stepResize(table,username);
+    if(table->engine == ENGINE_ROBIN){
+        removeFromRobinTable(table->robin,username,mode);
+    }else if(table->engine == ENGINE_SWISS){
+        removeFromSwissTable(table->swiss,username,mode);
+    }else{
+        removeFromHashTable(table->hashTable,table->M,username,mode,&table->counter);
+    }
+}
+
+/*
+@brief Prints the Hash Table with its engine
+@param table Hash Table to be printed
+@return
+*/
+void printTable(HASH_TABLE* table){
+    if(table->engine == ENGINE_CONCURRENT){
+        printConcurrentTable(table->concurrent);
+    }else if(table->engine == ENGINE_PERSISTENT){
+        printPersistentTable(table->persistent);
+    }else if(table->engine == ENGINE_ROBIN){
+        printRobinTable(table->robin);
+    }else if(table->engine == ENGINE_SWISS){
+        printSwissTable(table->swiss);
+    }else{
+        printHashTable(table->hashTable,table->M);
+    }
+    if(isResizing(table)){
+        printf("%d slots of the old table were moved, the rest are moved in the next operations\n",table->migrated);
+    }
+}
+
+/*
+@brief Rehashes the Hash Table with its engine using undeleted elements, a resize in progress is finished first
+@param table Hash Table to be rehashed
+@param mode Mode in which the program is run (1 = Normal Mode, 2 = Debug Mode)
+@return
+*/
+void rearrangeTable(HASH_TABLE* table, int mode){
+    if(table->engine == ENGINE_CONCURRENT){
+        enterEpoch(table->concurrent,0);
+        rebuildConcurrentTable(table->concurrent,0,1);
+        exitEpoch(table->concurrent,0);
+        if(mode == 2){
+            printConcurrentTable(table->concurrent);
+        }
+        return;
+    }
+    if(table->engine == ENGINE_PERSISTENT){
+        PERSISTENT_TABLE* persistent = table->persistent;
+        uint64_t keyCapacity = 2*liveKeyBytes(persistent);
+        rebuildPersistentTable(persistent,persistent->header->slotCount,
+                               keyCapacity > persistent->header->keyCapacity ? keyCapacity : persistent->header->keyCapacity);
+        if(mode == 2){
+            printPersistentTable(persistent);
+        }
+        return;
+    }
+    finishResize(table);
+    if(table->engine == ENGINE_ROBIN){
+        //Robin Hood Table has no tombstones to drop, only the key arena is compacted
+        compactArena(table->robin->slots,table->robin->size,table->arena);
+        if(mode == 2){
+            printRobinTable(table->robin);
+        }
+    }else if(table->engine == ENGINE_SWISS){
+        rearrangeSwissTable(table->swiss,mode);
+    }else{
+        table->counter = 0;
+        table->hashTable = rearrange(table->hashTable,table->M,mode,&table->counter,table->arena);
+        table->used = table->counter;
+    }
+}
+
+/*
+@brief Grows the Hash Table once so that the given number of new names fits under its load factor, a resize in progress is finished first
+@param table Hash Table
+@param count Number of names that will be inserted
+@return
+*/
+void reserveNames(HASH_TABLE* table, int count){
+    long long needed;
+    finishResize(table);
+    if(table->engine == ENGINE_CONCURRENT){
+        return;
+    }
+    if(table->engine == ENGINE_PERSISTENT){
+        PERSISTENT_TABLE* persistent = table->persistent;
+        uint64_t slotCount = persistent->header->slotCount;
+        needed = (long long)((persistent->header->used + (long long)count) / table->loadFactor) + 1;
+        while((long long)slotCount < needed){
+            slotCount *= 2;
+        }
+        if(slotCount > persistent->header->slotCount){
+            rebuildPersistentTable(persistent,slotCount,persistent->header->keyCapacity*(slotCount/persistent->header->slotCount));
+        }
+        return;
+    }
+    if(table->engine == ENGINE_ROBIN){
+        needed = (long long)((table->robin->counter + (long long)count) / table->loadFactor) + 1;
+        if(needed > table->robin->size){
+            beginResize(table,(int)needed,1);
+            finishResize(table);
+        }
+        return;
+    }
+    if(table->engine == ENGINE_SWISS){
+        needed = (long long)((table->swiss->counter + table->swiss->deleted + (long long)count) / table->loadFactor) + 1;
+        if(needed > table->swiss->groupCount*GROUP_SIZE){
+            beginResize(table,(int)needed,1);
+            finishResize(table);
+        }
+        return;
+    }
+    needed = (long long)((table->used + (long long)count) / table->loadFactor) + 1;
+    if(needed > table->M){
+        beginResize(table,nextPrime((int)needed),1);
+        finishResize(table);
+    }
+}
+
+/*
+@brief Inserts a name whose hash value is known without printing. The probe sequence of double hashing is walked once: a live copy of
+       the name stops it, a deleted copy is revived, otherwise the name takes the first tombstone before the empty slot.
+       The table must have room for the name and the name must not be in the old table of a resize
+@param table Hash Table to be inserted
+@param username Name to be inserted
+@param length Length of the name
+@param hash Hash value of the name
+@return Index of the name in the Hash Table (-1 = The name is already in the table)
+*/
+int insertHashedName(HASH_TABLE* table, char* username, int length, uint64_t hash){
+    int hashIndex, tombstone = -1, i = 0, attempts;
+    HASH_ITEM* item;
+    if(table->engine == ENGINE_CONCURRENT){
+        return insertToConcurrentTable(table->concurrent,username,0);
+    }
+    if(table->engine == ENGINE_PERSISTENT){
+        return insertToPersistentTable(table->persistent,username,length,hash);
+    }
+    if(table->engine == ENGINE_ROBIN){
+        if(findInRobinTable(table->robin,username,length,hash,1,&attempts) != -1){
+            return -1;
+        }
+        HASH_ITEM newItem;
+        setItemName(&newItem,table->arena,username,length);
+        newItem.hash = hash;
+        return placeInRobinTable(table->robin,newItem);
+    }
+    if(table->engine == ENGINE_SWISS){
+        if(findInSwissTable(table->swiss,username,length,hash,1,&attempts) != -1){
+            return -1;
+        }
+        hashIndex = findFreeSwissSlot(table->swiss,hash,&attempts);
+        if(table->swiss->control[hashIndex] == CONTROL_DELETED){
+            table->swiss->deleted--;
+        }
+        item = &table->swiss->slots[hashIndex];
+        setItemName(item,table->arena,username,length);
+        item->isDeleted = 0;
+        item->hash = hash;
+        table->swiss->control[hashIndex] = (int8_t)(hash & 0x7F);
+        table->swiss->counter++;
+        return hashIndex;
+    }
+
+    hashIndex = hashFunction(hash,0,table->M,1);
+    while(table->hashTable[hashIndex].length != EMPTY_SLOT){
+        item = &table->hashTable[hashIndex];
+        if(isSameName(item,username,length,hash)){
+            if(item->isDeleted == 0){
+                return -1;
+            }
+            //The deleted copy of the name is revived, its name is already stored
+            item->isDeleted = 0;
+            table->counter++;
+            return hashIndex;
+        }
+        if(item->isDeleted == 1 && tombstone == -1){
+            tombstone = hashIndex;
+        }
+        i++;
+        hashIndex = hashFunction(hash,i,table->M,1);
+    }
+    if(tombstone != -1){
+        hashIndex = tombstone;
+        dropItemName(&table->hashTable[hashIndex],table->arena);
+    }else{
+        table->used++;
+    }
+    item = &table->hashTable[hashIndex];
+    setItemName(item,table->arena,username,length);
+    item->isDeleted = 0;
+    item->hash = hash;
+    table->counter++;
+    return hashIndex;
+}
+
+/*
+@brief Searches a name whose hash value is known without printing. The name must not be in the old table of a resize
+@param table Hash Table to be searched
+@param username Name to be searched
+@param length Length of the name
+@param hash Hash value of the name
+@return Index of the name in the Hash Table (-1 = Not Found)
+*/
+int findHashedName(HASH_TABLE* table, char* username, int length, uint64_t hash){
+    int hashIndex, i = 0, attempts;
+    if(table->engine == ENGINE_CONCURRENT){
+        return searchInConcurrentTable(table->concurrent,username,0);
+    }
+    if(table->engine == ENGINE_PERSISTENT){
+        return findInPersistentTable(table->persistent,username,length,hash,1,&attempts);
+    }
+    if(table->engine == ENGINE_ROBIN){
+        return findInRobinTable(table->robin,username,length,hash,1,&attempts);
+    }
+    if(table->engine == ENGINE_SWISS){
+        return findInSwissTable(table->swiss,username,length,hash,1,&attempts);
+    }
+    hashIndex = hashFunction(hash,0,table->M,1);
+    while(table->hashTable[hashIndex].length != EMPTY_SLOT){
+        if(table->hashTable[hashIndex].isDeleted == 0 && isSameName(&table->hashTable[hashIndex],username,length,hash)){
+            return hashIndex;
+        }
+        i++;
+        hashIndex = hashFunction(hash,i,table->M,1);
+    }
+    return -1;
+}
+
+/*
+@brief Removes a name whose hash value is known without printing. The name must not be in the old table of a resize
+@param table Hash Table to be removed from
+@param username Name to be removed
+@param length Length of the name
+@param hash Hash value of the name
+@return Index of the removed name in the Hash Table (-1 = Not Found)
+*/
+int removeHashedName(HASH_TABLE* table, char* username, int length, uint64_t hash){
+    int index;
+    if(table->engine == ENGINE_CONCURRENT){
+        return removeFromConcurrentTable(table->concurrent,username,0);
+    }
+    if(table->engine == ENGINE_PERSISTENT){
+        return removeFromPersistentTable(table->persistent,username,length,hash);
+    }
+    index = findHashedName(table,username,length,hash);
+    if(index == -1){
+        return -1;
+    }
+    if(table->engine == ENGINE_ROBIN){
+        deleteRobinSlot(table->robin,index);
+    }else if(table->engine == ENGINE_SWISS){
+        deleteSwissSlot(table->swiss,index);
+    }else{
+        table->hashTable[index].isDeleted = 1;
+        table->counter--;
+    }
+    return index;
+}
+
+/*
+@brief Prefetches the first slots that a name with the given hash value probes, so they are in the cache when the name is reached
+@param table Hash Table
+@param hash Hash value of the name
+@return
+*/
+void prefetchName(HASH_TABLE* table, uint64_t hash){
+    int group;
+    if(table->engine == ENGINE_SWISS){
+        group = (int)((hash >> 7) & (table->swiss->groupCount - 1));
+        __builtin_prefetch(table->swiss->control + group*GROUP_SIZE);
+        __builtin_prefetch(table->swiss->slots + group*GROUP_SIZE);
+    }else if(table->engine == ENGINE_ROBIN){
+        __builtin_prefetch(table->robin->slots + (hash & (table->robin->size - 1)));
+    }else if(table->engine == ENGINE_PERSISTENT){
+        __builtin_prefetch(table->persistent->slots + (hash & (table->persistent->header->slotCount - 1)));
+    }else if(table->engine == ENGINE_DOUBLE){
+        __builtin_prefetch(table->hashTable + hash % table->M);
+    }
+}
+
+/*
+@brief Prefetches the long name of the first slot that a name with the given hash value probes and whose fingerprint matches.
+       It is called after the slots were prefetched, so the slot is read from the cache and the name is loaded before it is compared
+@param table Hash Table
+@param hash Hash value of the name
+@return
+*/
+void prefetchStoredName(HASH_TABLE* table, uint64_t hash){
+    HASH_ITEM* item = NULL;
+    unsigned match;
+    int group;
+    if(table->engine == ENGINE_SWISS){
+        group = (int)((hash >> 7) & (table->swiss->groupCount - 1));
+        match = matchControlGroup(table->swiss->control + group*GROUP_SIZE,(int8_t)(hash & 0x7F));
+        if(match != 0){
+            item = table->swiss->slots + group*GROUP_SIZE + __builtin_ctz(match);
+        }
+    }else if(table->engine == ENGINE_ROBIN){
+        item = table->robin->slots + (hash & (table->robin->size - 1));
+        if(item->hash != hash){
+            item = NULL;
+        }
+    }else if(table->engine == ENGINE_DOUBLE){
+        item = table->hashTable + hash % table->M;
+        if(item->hash != hash){
+            item = NULL;
+        }
+    }
+    if(item != NULL && item->length >= INLINE_NAME){
+        __builtin_prefetch(item->name.stored);
+    }
+}
+
+/*
+@brief Finds the lengths and hash values of all names of a batch, so the slots of the next names can be prefetched while a name is probed
+@param usernames Names of the batch
+@param count Number of names
+@param lengths Array of the lengths of the names is written to it, it must be freed by the caller
+@return Hash values of the names
+*/
+uint64_t* calculateHashes(char** usernames, int count, int** lengths){
+    uint64_t* hashes = (uint64_t*) malloc(sizeof(uint64_t)*(count > 0 ? count : 1));
+    int i;
+    *lengths = (int*) malloc(sizeof(int)*(count > 0 ? count : 1));
+    if(hashes == NULL || *lengths == NULL){
+        printf("Memory allocation error!");
+        exit(1);
+    }
+    for(i=0;i<count;i++){
+        (*lengths)[i] = (int)strlen(usernames[i]);
+        hashes[i] = hashName(usernames[i],(*lengths)[i]);
+    }
+    return hashes;
+}
+
+/*
+@brief Inserts an array of names without printing. The table is grown once for the whole batch, all names are hashed first and the slots
+       of the name PREFETCH_DISTANCE positions ahead are prefetched, so the cache misses of several names overlap. Half way there the
+       long name of its slot is prefetched too
+@param table Hash Table to be inserted
+@param usernames Names to be inserted
+@param count Number of names
+@return Number of names that were inserted, the others were already in the table
+*/
+int insertMany(HASH_TABLE* table, char** usernames, int count){
+    int* lengths;
+    uint64_t* hashes = calculateHashes(usernames,count,&lengths);
+    int i, inserted = 0;
+    reserveNames(table,count);
+    for(i=0;i<count && i<PREFETCH_DISTANCE;i++){
+        prefetchName(table,hashes[i]);
+    }
+    for(i=0;i<count;i++){
+        if(i + PREFETCH_DISTANCE < count){
+            prefetchName(table,hashes[i + PREFETCH_DISTANCE]);
+        }
+        if(i + PREFETCH_DISTANCE/2 < count){
+            prefetchStoredName(table,hashes[i + PREFETCH_DISTANCE/2]);
+        }
+        if(insertHashedName(table,usernames[i],lengths[i],hashes[i]) != -1){
+            inserted++;
+        }
+    }
+    if(table->engine == ENGINE_PERSISTENT){
+        //The batch is made durable with one synchronization
+        commitPersistentTable(table->persistent);
+    }
+    free(hashes);
+    free(lengths);
+    return inserted;
+}
+
+/*
+@brief Searches an array of names without printing, the slots of the name PREFETCH_DISTANCE positions ahead and the long name of the
+       slot of the name PREFETCH_DISTANCE/2 positions ahead are prefetched
+@param table Hash Table to be searched
+@param usernames Names to be searched
+@param count Number of names
+@return Array of the indices of the names (-1 = Not Found), it must be freed by the caller
+*/
+int* findMany(HASH_TABLE* table, char** usernames, int count){
+    int* lengths;
+    uint64_t* hashes = calculateHashes(usernames,count,&lengths);
+    int* indices = (int*) malloc(sizeof(int)*(count > 0 ? count : 1));
+    int i;
+    if(indices == NULL){
+        printf("Memory allocation error!");
+        exit(1);
+    }
+    finishResize(table);
+    for(i=0;i<count && i<PREFETCH_DISTANCE;i++){
+        prefetchName(table,hashes[i]);
+    }
+    for(i=0;i<count;i++){
+        if(i + PREFETCH_DISTANCE < count){
+            prefetchName(table,hashes[i + PREFETCH_DISTANCE]);
+        }
+        if(i + PREFETCH_DISTANCE/2 < count){
+            prefetchStoredName(table,hashes[i + PREFETCH_DISTANCE/2]);
+        }
+        indices[i] = findHashedName(table,usernames[i],lengths[i],hashes[i]);
+    }
+    free(hashes);
+    free(lengths);
+    return indices;
+}
+
+/*
+@brief Finds the number of slots (groups for Swiss Table) that a successful search of the name in a slot probes
+@param table Hash Table, it must not be resized
+@param index Index of a slot that has a name
+@return Probe length of the name
+*/
+int probeLength(HASH_TABLE* table, int index){
+    int i, group, groupMask;
+    HASH_ITEM* item;
+    if(table->engine == ENGINE_ROBIN){
+        return robinDistance(table->robin,index) + 1;
+    }
+    if(table->engine == ENGINE_PERSISTENT){
+        uint64_t mask = table->persistent->header->slotCount - 1;
+        return (int)((index - table->persistent->slots[index].hash) & mask) + 1;
+    }
+    if(table->engine == ENGINE_CONCURRENT){
+        CONCURRENT_SLOTS* slots = atomic_load(&table->concurrent->slots);
+        return ((index - (int)(atomic_load(&slots->names[index])->hash & (slots->size - 1))) & (slots->size - 1)) + 1;
+    }
+    if(table->engine == ENGINE_SWISS){
+        groupMask = table->swiss->groupCount - 1;
+        group = (int)((table->swiss->slots[index].hash >> 7) & groupMask);
+        for(i=0;group != index / GROUP_SIZE;i++){
+            group = (group + i + 1) & groupMask;
+        }
+        return i + 1;
+    }
+    item = &table->hashTable[index];
+    for(i=0;hashFunction(item->hash,i,table->M,1) != index;i++);
+    return i + 1;
+}
+
+/*
+@brief Counts the slots (groups for Swiss Table) that a search of a name probes, without printing
+@param table Hash Table, it must not be resized
+@param username Name to be searched
+@param length Length of the name
+@param hash Hash value of the name
+@return Number of probes of the search
+*/
+int countProbes(HASH_TABLE* table, char* username, int length, uint64_t hash){
+    int i, index, mask, attempts;
+    if(table->engine == ENGINE_ROBIN){
+        findInRobinTable(table->robin,username,length,hash,1,&attempts);
+        return attempts;
+    }
+    if(table->engine == ENGINE_SWISS){
+        findInSwissTable(table->swiss,username,length,hash,1,&attempts);
+        return attempts;
+    }
+    if(table->engine == ENGINE_PERSISTENT){
+        findInPersistentTable(table->persistent,username,length,hash,1,&attempts);
+        return attempts;
+    }
+    if(table->engine == ENGINE_CONCURRENT){
+        CONCURRENT_SLOTS* slots = atomic_load(&table->concurrent->slots);
+        CONCURRENT_NAME* name;
+        mask = slots->size - 1;
+        index = (int)(hash & mask);
+        for(i=0;i<slots->size;i++){
+            name = atomic_load(&slots->names[index]);
+            if(name == NULL || (name != &removedName && name->hash == hash && name->length == length &&
+                                equalNames(name->username,username,length))){
+                break;
+            }
+            index = (index + 1) & mask;
+        }
+        return i + 1;
+    }
+    i = 0;
+    index = hashFunction(hash,0,table->M,1);
+    while(table->hashTable[index].length != EMPTY_SLOT && i < table->M){
+        if(table->hashTable[index].isDeleted == 0 && isSameName(&table->hashTable[index],username,length,hash)){
+            break;
+        }
+        i++;
+        index = hashFunction(hash,i,table->M,1);
+    }
+    return i + 1;
+}
+
+/*
+@brief Collects the statistics of the Hash Table without printing. Successful probe lengths are found for every name, unsuccessful ones
+       with STATS_SAMPLES names that are not in the table. A resize in progress is finished first
+@param table Hash Table
+@param stats Statistics are written to it
+@return
+*/
+void collectStats(HASH_TABLE* table, TABLE_STATS* stats){
+    long long squares = 0, total = 0;
+    int i, length, nameLength, isName;
+    char username[32];
+    uint64_t hash;
+    CONCURRENT_SLOTS* slots = NULL;
+    CONCURRENT_NAME* name;
+    finishResize(table);
+    memset(stats,0,sizeof(TABLE_STATS));
+    if(table->engine == ENGINE_ROBIN){
+        stats->slots = table->robin->size;
+    }else if(table->engine == ENGINE_PERSISTENT){
+        stats->slots = (long long)table->persistent->header->slotCount;
+        stats->tombstones = (long long)(table->persistent->header->used - table->persistent->header->counter);
+    }else if(table->engine == ENGINE_SWISS){
+        stats->slots = table->swiss->groupCount*GROUP_SIZE;
+        stats->tombstones = table->swiss->deleted;
+    }else if(table->engine == ENGINE_CONCURRENT){
+        slots = atomic_load(&table->concurrent->slots);
+        stats->slots = slots->size;
+    }else{
+        stats->slots = table->M;
+        stats->tombstones = table->used - table->counter;
+    }
+    for(i=0;i<stats->slots;i++){
+        if(table->engine == ENGINE_ROBIN){
+            isName = table->robin->slots[i].length >= 0;
+        }else if(table->engine == ENGINE_PERSISTENT){
+            isName = table->persistent->slots[i].length >= 0 && table->persistent->slots[i].isDeleted == 0;
+        }else if(table->engine == ENGINE_SWISS){
+            isName = table->swiss->control[i] >= 0;
+        }else if(table->engine == ENGINE_CONCURRENT){
+            name = atomic_load(&slots->names[i]);
+            isName = name != NULL && name != &removedName;
+            stats->tombstones += name == &removedName;
+        }else{
+            isName = table->hashTable[i].length >= 0 && table->hashTable[i].isDeleted == 0;
+        }
+        if(isName){
+            length = probeLength(table,i);
+            stats->hits[length < HISTOGRAM_SIZE ? length - 1 : HISTOGRAM_SIZE - 1]++;
+            total += length;
+            squares += (long long)length*length;
+            stats->names++;
+            if(length > stats->maxHit){
+                stats->maxHit = length;
+            }
+        }
+    }
+    stats->meanHit = stats->names > 0 ? (double)total/stats->names : 0.0;
+    stats->deviationHit = stats->names > 0 ? sqrt((double)squares/stats->names - stats->meanHit*stats->meanHit) : 0.0;
+    stats->loadFactor = (double)(stats->names + stats->tombstones)/stats->slots;
+    stats->tombstoneRatio = (double)stats->tombstones/stats->slots;
+
+    total = 0;
+    for(i=0;i<STATS_SAMPLES;i++){
+        //The sample names contain a character that names read with scanf cannot have, so they are never in the table
+        sprintf(username,"missing %d",i);
+        nameLength = (int)strlen(username);
+        hash = hashName(username,nameLength);
+        length = countProbes(table,username,nameLength,hash);
+        stats->misses[length < HISTOGRAM_SIZE ? length - 1 : HISTOGRAM_SIZE - 1]++;
+        total += length;
+        if(length > stats->maxMiss){
+            stats->maxMiss = length;
+        }
+    }
+    stats->meanMiss = (double)total/STATS_SAMPLES;
+}
+
+/*
+@brief Prints the statistics of the Hash Table: its load, the probe lengths of successful and unsuccessful searches and their histograms
+@param table Hash Table
+@return
+*/
+void printTableStats(HASH_TABLE* table){
+    TABLE_STATS stats;
+    int i;
+    collectStats(table,&stats);
+    printf("\n%lld names and %lld tombstones in %lld slots: load %.3f, tombstones %.2f%%\n",stats.names,stats.tombstones,stats.slots,
+           stats.loadFactor,100.0*stats.tombstoneRatio);
+    printf("Successful searches: mean %.3f, deviation %.3f, max %d\n",stats.meanHit,stats.deviationHit,stats.maxHit);
+    printf("Unsuccessful searches: mean %.3f, max %d (%d samples)\n",stats.meanMiss,stats.maxMiss,STATS_SAMPLES);
+    printf("Probes\tHits\tMisses\n");
+    for(i=0;i<HISTOGRAM_SIZE && (i<stats.maxHit || i<stats.maxMiss);i++){
+        printf("%s%d\t%.2f%%\t%.2f%%\n",i == HISTOGRAM_SIZE - 1 ? ">=" : "",i + 1,
+               stats.names > 0 ? 100.0*stats.hits[i]/stats.names : 0.0,100.0*stats.misses[i]/STATS_SAMPLES);
+    }
+}
+
+/*
+@brief Runs a churn workload without printing: every operation picks a random name of a pool and removes it if it is in the table,
+       otherwise inserts it, so there are as many removals as insertions and about half of the pool stays in the table
+@param table Hash Table
+@param poolSize Number of different names
+@param operations Number of operations
+@return
+*/
+void churnTable(HASH_TABLE* table, int poolSize, int operations){
+    char* names = (char*) malloc(sizeof(char)*32*poolSize);
+    uint64_t random = 0x9E3779B97F4A7C15ULL;
+    uint64_t hash;
+    char* username;
+    int i, length;
+    if(names == NULL){
+        printf("Memory allocation error!");
+        exit(1);
+    }
+    for(i=0;i<poolSize;i++){
+        sprintf(names + 32*i,"churn%d@example.com",i);
+    }
+    for(i=0;i<operations;i++){
+        random ^= random << 13;
+        random ^= random >> 7;
+        random ^= random << 17;
+        username = names + 32*(random % poolSize);
+        length = (int)strlen(username);
+        hash = hashName(username,length);
+        stepResize(table,username);
+        if(removeHashedName(table,username,length,hash) == -1){
+            startResize(table,1);
+            promoteName(table,username);
+            insertHashedName(table,username,length,hash);
+        }
+    }
+    if(table->engine == ENGINE_PERSISTENT){
+        commitPersistentTable(table->persistent);
+    }
+    free(names);
+}
+
+/*
+@brief Frees the Hash Table of any engine with its long names, the file of a persistent table is closed
+@param table Hash Table to be freed
+@return
+*/
+void freeHashTable(HASH_TABLE* table){
+    finishResize(table);
+    if(table->engine == ENGINE_ROBIN){
+        freeRobinTable(table->robin);
+    }else if(table->engine == ENGINE_SWISS){
+        freeSwissTable(table->swiss);
+    }else if(table->engine == ENGINE_CONCURRENT){
+        freeConcurrentTable(table->concurrent);
+    }else if(table->engine == ENGINE_PERSISTENT){
+        closePersistentTable(table->persistent);
+    }else{
+        free(table->hashTable);
+    }
+    freeArenaChunks(table->arena);
+    free(table->arena);
+}
+
+/*
+@brief Reads the monotonic clock in nanoseconds, for timing single operations
+@return Nanoseconds from an arbitrary point
+*/
+uint64_t getNanoseconds(){
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC,&now);
+    return (uint64_t)now.tv_sec*1000000000ULL + now.tv_nsec;
+}
+
+/*
+@brief Compares two latencies for qsort
+@param a First latency
+@param b Second latency
+@return Negative, zero or positive as a is smaller than, equal to or greater than b
+*/
+int compareLatencies(const void* a, const void* b){
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+/*
+@brief Generates the operations of a workload on 2*nameCount names. Uniform and Zipf workloads are 80% searches, 10% insertions and
+       10% removals, the churn workload is 10% searches, 45% insertions and 45% removals. Zipf ranks are spread over the names with a
+       multiplicative permutation, so the popular names are not all among the preloaded ones
+@param workload WORKLOAD_UNIFORM, WORKLOAD_ZIPF or WORKLOAD_CHURN
+@param nameCount Number of preloaded names
+@param operations Number of operations
+@param types Type of every operation is written to it ('s' = search, 'i' = insert, 'r' = remove)
+@return Array of the indices of the names of the operations, it must be freed by the caller
+*/
+int* createWorkload(int workload, int nameCount, int operations, char* types){
+    int universe = 2*nameCount;
+    int* keys = (int*) malloc(sizeof(int)*operations);
+    double* cumulative = NULL;
+    uint64_t random = 0x9E3779B97F4A7C15ULL;
+    double sum = 0, target;
+    int i, low, high, middle, percent;
+    if(keys == NULL){
+        printf("Memory allocation error!");
+        exit(1);
+    }
+    if(workload == WORKLOAD_ZIPF){
+        cumulative = (double*) malloc(sizeof(double)*universe);
+        if(cumulative == NULL){
+            printf("Memory allocation error!");
+            exit(1);
+        }
+        for(i=0;i<universe;i++){
+            sum += 1.0 / pow(i + 1,ZIPF_EXPONENT);
+            cumulative[i] = sum;
+        }
+    }
+    for(i=0;i<operations;i++){
+        random ^= random << 13;
+        random ^= random >> 7;
+        random ^= random << 17;
+        if(workload == WORKLOAD_ZIPF){
+            //The rank is the first one whose cumulative weight reaches a uniform point of the total weight
+            target = (double)(random >> 11) / 9007199254740992.0 * sum;
+            low = 0;
+            high = universe - 1;
+            while(low < high){
+                middle = (low + high) / 2;
+                if(cumulative[middle] < target){
+                    low = middle + 1;
+                }else{
+                    high = middle;
+                }
+            }
+            keys[i] = (int)(((uint64_t)low*2654435761ULL) % universe);
+        }else{
+            keys[i] = (int)((random >> 16) % universe);
+        }
+        percent = (int)(random % 100);
+        if(workload == WORKLOAD_CHURN){
+            types[i] = percent < 10 ? 's' : percent < 55 ? 'i' : 'r';
+        }else{
+            types[i] = percent < 80 ? 's' : percent < 90 ? 'i' : 'r';
+        }
+    }
+    free(cumulative);
+    return keys;
+}
+
+/*
+@brief Runs a workload on every given engine without printing its operations, and prints the throughput, the median and 99th percentile
+       latency of an operation and the statistics of the table at the end. A persistent table commits its log once at the end
+@param engines Engines to be compared
+@param engineCount Number of engines
+@param workload WORKLOAD_UNIFORM, WORKLOAD_ZIPF or WORKLOAD_CHURN
+@param nameCount Number of names that are inserted before the workload, the workload uses twice as many
+@param operations Number of operations
+@param loadFactor Maximum ratio of used slots
+@param persistPath File of the persistent table, it must not exist
+@return
+*/
+void runWorkloadBenchmark(int* engines, int engineCount, int workload, int nameCount, int operations, float loadFactor, char* persistPath){
+    char* engineNames[] = {"", "double", "swiss", "concurrent", "robin", "persistent"};
+    char* workloadNames[] = {"", "uniform", "zipf", "churn"};
+    char* names = (char*) malloc(sizeof(char)*BENCHMARK_NAME*2*nameCount);
+    char** preload = (char**) malloc(sizeof(char*)*nameCount);
+    char* types = (char*) malloc(sizeof(char)*operations);
+    uint32_t* latencies = (uint32_t*) malloc(sizeof(uint32_t)*operations);
+    int* keys;
+    int i, e, length;
+    uint64_t start, hash;
+    double elapsed;
+    char* username;
+    HASH_TABLE table;
+    TABLE_STATS stats;
+    if(names == NULL || preload == NULL || types == NULL || latencies == NULL){
+        printf("Memory allocation error!");
+        exit(1);
+    }
+    for(i=0;i<2*nameCount;i++){
+        sprintf(names + BENCHMARK_NAME*i,"user%d@example.com",i);
+    }
+    for(i=0;i<nameCount;i++){
+        preload[i] = names + BENCHMARK_NAME*i;
+    }
+    keys = createWorkload(workload,nameCount,operations,types);
+
+    printf("Workload %s: %d names, %d operations\n",workloadNames[workload],nameCount,operations);
+    printf("Engine\t\tMops/s\tp50 ns\tp99 ns\tLoad\tTombs\tHit\tMaxHit\tMiss\tMaxMiss\n");
+    for(e=0;e<engineCount;e++){
+        table = createHashTable(engines[e],(int)(nameCount / loadFactor) + 1,loadFactor);
+        if(engines[e] == ENGINE_PERSISTENT){
+            table.persistent = openPersistentTable(persistPath,(int)(nameCount / loadFactor) + 1,loadFactor);
+        }
+        insertMany(&table,preload,nameCount);
+
+        elapsed = getTime();
+        for(i=0;i<operations;i++){
+            username = names + BENCHMARK_NAME*keys[i];
+            start = getNanoseconds();
+            length = (int)strlen(username);
+            hash = hashName(username,length);
+            stepResize(&table,username);
+            if(types[i] == 's'){
+                findHashedName(&table,username,length,hash);
+            }else if(types[i] == 'i'){
+                startResize(&table,1);
+                promoteName(&table,username);
+                insertHashedName(&table,username,length,hash);
+            }else{
+                removeHashedName(&table,username,length,hash);
+            }
+            latencies[i] = (uint32_t)(getNanoseconds() - start);
+        }
+        if(engines[e] == ENGINE_PERSISTENT){
+            commitPersistentTable(table.persistent);
+        }
+        elapsed = getTime() - elapsed;
+
+        qsort(latencies,operations,sizeof(uint32_t),compareLatencies);
+        collectStats(&table,&stats);
+        printf("%-10s\t%.2f\t%u\t%u\t%.3f\t%.2f%%\t%.3f\t%d\t%.3f\t%d\n",engineNames[engines[e]],operations / elapsed / 1e6,
+               latencies[operations/2],latencies[(int)((long long)operations*99/100)],stats.loadFactor,100.0*stats.tombstoneRatio,
+               stats.meanHit,stats.maxHit,stats.meanMiss,stats.maxMiss);
+        freeHashTable(&table);
+    }
+    free(keys);
+    free(latencies);
+    free(types);
+    free(preload);
+    free(names);
+}
+
+/*
+@brief Reads the names of a file, one name per line. The file is read into one buffer and the names point into it
+@param path Path of the file
+@param count Number of names is written to it
+@param buffer Buffer of the names is written to it, it must be freed with the returned array
+@return Array of the names
+*/
+char** readNames(char* path, int* count, char** buffer){
+    FILE* file = fopen(path,"rb");
+    long size;
+    int i, length, capacity = 1024;
+    char* p;
+    char** usernames;
+    if(file == NULL){
+        printf("%s could not be opened!\n",path);
+        exit(1);
+    }
+    fseek(file,0,SEEK_END);
+    size = ftell(file);
+    fseek(file,0,SEEK_SET);
+    *buffer = (char*) malloc(size + 1);
+    usernames = (char**) malloc(sizeof(char*)*capacity);
+    if(*buffer == NULL || usernames == NULL){
+        printf("Memory allocation error!");
+        exit(1);
+    }
+    size = (long)fread(*buffer,1,size,file);
+    fclose(file);
+    (*buffer)[size] = '\0';
+
+    *count = 0;
+    p = *buffer;
+    while(*p != '\0'){
+        //Every line ends at its newline, carriage returns and empty lines are skipped
+        for(i=0;p[i] != '\0' && p[i] != '\n';i++);
+        length = i;
+        if(p[i] == '\n'){
+            p[i++] = '\0';
+        }
+        if(length > 0 && p[length - 1] == '\r'){
+            p[--length] = '\0';
+        }
+        if(length > 0){
+            if(*count == capacity){
+                capacity *= 2;
+                usernames = (char**) realloc(usernames,sizeof(char*)*capacity);
+                if(usernames == NULL){
+                    printf("Memory allocation error!");
+                    exit(1);
+                }
+            }
+            usernames[(*count)++] = p;
+        }
+        p += i;
+    }
+    return usernames;
+}
+
+int main(int argc, char* argv[]){
+    int N;//Expected number of elements
+    int M;//Initial size of hash table
+    int choice;//transaction number to be selected
+    float loadFactor;//Load Factor of hash table
+    char username[256];//Name read from the input, the tables copy it
+    int mode;//Program mode
+    int engine = ENGINE_DOUBLE;//Hash Table engine, set with -e
+    int benchmark = 0;//Number of names of the concurrent scaling benchmark, set with -b
+    char* loadPath = NULL;//File of names that are inserted with insertMany, set with -l
+    char* findPath = NULL;//File of names that are searched with findMany, set with -f
+    int churn = 0;//Number of operations of the churn workload, set with -c
+    char* persistPath = NULL;//File of the persistent table, set with -p
+    int workload = 0;//Workload of the engine comparison, set with -w
+    int workloadNames = 100000;//Number of preloaded names of the workload, set with -n
+    int workloadOperations = 1000000;//Number of operations of the workload, set with -o
+    int isEngineSet = 0;//1 if an engine was selected, the workload is then only run on it
+
+    int i;
+    for(i=1;i<argc;i++){
+        if((strcmp(argv[i],"-e") == 0 || strcmp(argv[i],"--engine") == 0) && i+1 < argc){
+            i++;
+            if(strcmp(argv[i],"swiss") == 0){
+                engine = ENGINE_SWISS;
+            }else if(strcmp(argv[i],"double") == 0){
+                engine = ENGINE_DOUBLE;
+            }else if(strcmp(argv[i],"concurrent") == 0){
+                engine = ENGINE_CONCURRENT;
+            }else if(strcmp(argv[i],"robin") == 0){
+                engine = ENGINE_ROBIN;
+            }else{
+                printf("Unknown engine %s, use double, swiss, concurrent or robin\n",argv[i]);
+                return 1;
+            }
+            isEngineSet = 1;
+        }else if((strcmp(argv[i],"-H") == 0 || strcmp(argv[i],"--hash") == 0) && i+1 < argc){
+            i++;
+            if(strcmp(argv[i],"fast") == 0){
+                hashName = calculateFastHash;
+            }else if(strcmp(argv[i],"fnv") == 0){
+                hashName = calculateFnvHash;
+            }else{
+                printf("Unknown hash function %s, use fast or fnv\n",argv[i]);
+                return 1;
+            }
+        }else if((strcmp(argv[i],"-b") == 0 || strcmp(argv[i],"--benchmark") == 0) && i+1 < argc){
+            benchmark = atoi(argv[++i]);
+            if(benchmark <= 0){
+                printf("The number of benchmark names must be positive\n");
+                return 1;
+            }
+        }else if((strcmp(argv[i],"-l") == 0 || strcmp(argv[i],"--load") == 0) && i+1 < argc){
+            loadPath = argv[++i];
+        }else if((strcmp(argv[i],"-f") == 0 || strcmp(argv[i],"--find") == 0) && i+1 < argc){
+            findPath = argv[++i];
+        }else if((strcmp(argv[i],"-c") == 0 || strcmp(argv[i],"--churn") == 0) && i+1 < argc){
+            churn = atoi(argv[++i]);
+        }else if((strcmp(argv[i],"-p") == 0 || strcmp(argv[i],"--persist") == 0) && i+1 < argc){
+            persistPath = argv[++i];
+            engine = ENGINE_PERSISTENT;
+            isEngineSet = 1;
+        }else if((strcmp(argv[i],"-w") == 0 || strcmp(argv[i],"--workload") == 0) && i+1 < argc){
+            i++;
+            if(strcmp(argv[i],"uniform") == 0){
+                workload = WORKLOAD_UNIFORM;
+            }else if(strcmp(argv[i],"zipf") == 0){
+                workload = WORKLOAD_ZIPF;
+            }else if(strcmp(argv[i],"churn") == 0){
+                workload = WORKLOAD_CHURN;
+            }else{
+                printf("Unknown workload %s, use uniform, zipf or churn\n",argv[i]);
+                return 1;
+            }
+        }else if((strcmp(argv[i],"-n") == 0 || strcmp(argv[i],"--names") == 0) && i+1 < argc){
+            workloadNames = atoi(argv[++i]);
+        }else if((strcmp(argv[i],"-o") == 0 || strcmp(argv[i],"--operations") == 0) && i+1 < argc){
+            workloadOperations = atoi(argv[++i]);
+        }else{
+            printf("Usage: %s [-e double|swiss|concurrent|robin] [-H fast|fnv] [-b names] [-l file] [-f file] [-c operations] [-p file]\n"
+                   "          [-w uniform|zipf|churn] [-n names] [-o operations]\n",argv[0]);
+            return 1;
+        }
+    }
+
+    if(benchmark > 0){
+        //Scaling benchmark of the concurrent table, nothing is read from the input
+        runConcurrentBenchmark(benchmark,DEFAULT_LOAD_FACTOR);
+        return 0;
+    }
+    if(workload > 0){
+        //Engine comparison, nothing is read from the input. Without -e or -p all engines that need no file are compared
+        int engines[] = {ENGINE_DOUBLE, ENGINE_SWISS, ENGINE_ROBIN, ENGINE_CONCURRENT};
+        struct stat status;
+        if(workloadNames <= 0 || workloadOperations <= 0){
+            printf("The number of names and operations of the workload must be positive\n");
+            return 1;
+        }
+        if(persistPath != NULL && stat(persistPath,&status) == 0){
+            printf("%s already exists, the workload needs a new file\n",persistPath);
+            return 1;
+        }
+        if(isEngineSet){
+            runWorkloadBenchmark(&engine,1,workload,workloadNames,workloadOperations,DEFAULT_LOAD_FACTOR,persistPath);
+        }else{
+            runWorkloadBenchmark(engines,4,workload,workloadNames,workloadOperations,DEFAULT_LOAD_FACTOR,persistPath);
+        }
+        return 0;
+    }
+
+    printf("Enter 1 to run in normal mode and 2 for debug mode(1/2): ");
+    scanf("%d",&mode);
+    printf("Enter the expected number of elements(N): ");
+    scanf("%d",&N);
+    printf("Enter the Load Factor(alpha): ");
+    scanf("%f",&loadFactor);
+    printf("Enter the table size(M): ");
+    scanf("%d",&M);
+    if(loadFactor <= 0 || loadFactor >= 1){
+        loadFactor = DEFAULT_LOAD_FACTOR;
+    }
+    if(N / loadFactor > M){
+        //The table starts large enough for N names, it grows automatically when more names are inserted
+        M = (int)(N / loadFactor) + 1;
+    }
+
+    //Hash Table Initialization
+    HASH_TABLE table = createHashTable(engine,M,loadFactor);
+    if(engine == ENGINE_PERSISTENT){
+        //An existing file is mapped as it is, only the log of an unclean shutdown is replayed
+        double startTime = getTime();
+        table.persistent = openPersistentTable(persistPath,M,loadFactor);
+        printf("%s was opened with %llu names in %.6f seconds\n",persistPath,
+               (unsigned long long)table.persistent->header->counter,getTime() - startTime);
+    }
+    
+    if(table.persistent == NULL || table.persistent->isNew){
+        //Fill the table with some names
+        insertName(&table,"bilal",mode);
+        insertName(&table,"mustafa",mode);
+        insertName(&table,"ali",mode);
+        insertName(&table,"mehmet",mode);
+        insertName(&table,"veli",mode);
+        insertName(&table,"ayse",mode);
+        insertName(&table,"fatma",mode);
+    }
+    
+    printTable(&table);
+
+    if(loadPath != NULL){
+        //Names of the file are inserted as one batch, one name per line
+        char* buffer;
+        int count;
+        char** names = readNames(loadPath,&count,&buffer);
+        double startTime = getTime();
+        int inserted = insertMany(&table,names,count);
+        printf("\n%d of %d names in %s were inserted in %.3f seconds\n",inserted,count,loadPath,getTime() - startTime);
+        free(names);
+        free(buffer);
+    }
+    if(findPath != NULL){
+        char* buffer;
+        int count, found = 0;
+        char** names = readNames(findPath,&count,&buffer);
+        double startTime = getTime();
+        int* indices = findMany(&table,names,count);
+        double elapsed = getTime() - startTime;
+        for(i=0;i<count;i++){
+            if(indices[i] != -1){
+                found++;
+            }
+            if(mode == 2){
+                printf("%s: %d\n",names[i],indices[i]);
+            }
+        }
+        printf("\n%d of %d names in %s were found in %.3f seconds\n",found,count,findPath,elapsed);
+        free(indices);
+        free(names);
+        free(buffer);
+    }
+
+    if(churn > 0){
+        //Names of a pool of 2N names are inserted and removed at random, then the probe lengths show how the engine copes
+        double startTime = getTime();
+        churnTable(&table,2*(N > 0 ? N : 1),churn);
+        printf("\n%d churn operations were run in %.3f seconds\n",churn,getTime() - startTime);
+        printTableStats(&table);
+    }
+
+    while(1){
+        printf("\n\n1-Insert\n2-Search\n3-Remove\n4-Print\n5-Rearrange\n6-Exit\n7-Statistics\n\n");
+        scanf("%d",&choice);
+		
+        switch(choice){
+            case 1:
+                printf("Enter the user name: ");
+                scanf("%255s",username);
+                insertName(&table,username,mode);
+                break;
+
+            case 2:
+                printf("Enter the user name: ");
+                scanf("%255s",username);
+                int index = searchName(&table,username,mode);
+                if(mode == 1){
+                    if(index != -1){
+                        printf("%s was found in %d\n",username,index);
+                    }else{
+                        printf("%s was not found in the table!\n",username);
+                    }
+                }else{
+                    printTable(&table);
+                }
                 break;
 
             case 3:
                 printf("Enter the user name: ");
-                scanf("%s",username);
-                removeFromHashTable(hashTable,M,username,mode,&counter);
+                scanf("%255s",username);
+                removeName(&table,username,mode);
                 break;
 
             case 4:
-                printHashTable(hashTable,M);
+                printTable(&table);
                 break;
             
             case 5:
-                counter = 0;
-                hashTable = rearrange(hashTable,M,mode,&counter,N);
+                rearrangeTable(&table,mode);
+                break;
+
+            case 7:
+                printTableStats(&table);
                 break;
             
             default:
+                freeHashTable(&table);
                 return 0;
                 break;
             }
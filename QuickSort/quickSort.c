@@ -1,6 +1,85 @@
 #include <stdio.h> 
 #include <time.h>
 #include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <unistd.h>
+
+#define SERIAL_CUTOFF 16384//Ranges with at most this many elements are matched serially
+#define PARTITION_CUTOFF 262144//Ranges with more elements are partitioned in parallel
+#define BLOCK_SIZE 65536//Minimum number of elements of a block of a parallel partition
+#define MAX_BLOCKS 256//Maximum number of blocks of a parallel partition
+#define MAX_WORKERS 64//Maximum number of threads of the task pool
+
+/*
+@brief a task of the pool, the function is called with the argument and the index of the thread that runs it
+*/
+typedef struct TASK{
+    void (*run)(void* argument, int worker);
+    void* argument;
+}TASK;
+
+/*
+@brief a deque of tasks. Its owner pushes and pops tasks at the bottom, other threads steal the oldest tasks from the top,
+       which are the largest ranges of the recursion
+*/
+typedef struct TASK_QUEUE{
+    TASK* tasks;
+    int top;//index of the oldest task
+    int bottom;//index after the newest task
+    int capacity;
+    pthread_mutex_t lock;
+}TASK_QUEUE;
+
+/*
+@brief a work-stealing pool. pending counts the tasks that were submitted and have not finished, the threads stop when it becomes 0
+*/
+typedef struct TASK_POOL{
+    TASK_QUEUE queues[MAX_WORKERS];
+    int workerCount;
+    atomic_int pending;
+}TASK_POOL;
+
+/*
+@brief a thread of the pool
+*/
+typedef struct WORKER{
+    TASK_POOL* pool;
+    int index;
+}WORKER;
+
+/*
+@brief arguments of a task that matches a range of locks and keys
+*/
+typedef struct MATCH_TASK{
+    TASK_POOL* pool;
+    int* locks;
+    int* keys;
+    int* buffer;//temporary array as large as locks, a range only uses its own part
+    int left;
+    int right;
+}MATCH_TASK;
+
+/*
+@brief a block of a parallel partition. Its counts are found in the first step, its elements are written to the buffer at its offsets
+       in the second step and copied back in the third step
+*/
+typedef struct PARTITION_BLOCK{
+    int* arr;
+    int* buffer;
+    int start;
+    int end;//index after the last element of the block
+    int pivot;
+    int smaller;//number of elements smaller than the pivot
+    int equal;//number of elements equal to the pivot
+    int smallerOffset;//index of the first smaller element of the block in the partitioned range
+    int equalOffset;
+    int largerOffset;
+    int step;//1 = count, 2 = scatter, 3 = copy back
+    atomic_int* done;//number of finished blocks of the step
+}PARTITION_BLOCK;
 
 /*
 @brief swaps two numbers in an array
@@ -89,15 +168,359 @@ void matchPairs(int locks[], int keys[], int left, int right){
     return;
 }
 
+/*
+@brief a function that adds a task to the bottom of the deque of a thread
+
+@param pool task pool
+@param worker index of the thread
+@param run function of the task
+@param argument argument of the function
+
+@return
+*/
+void submitTask(TASK_POOL* pool, int worker, void (*run)(void* argument, int worker), void* argument){
+    TASK_QUEUE* queue = &pool->queues[worker];
+    atomic_fetch_add(&pool->pending,1);
+    pthread_mutex_lock(&queue->lock);
+    if(queue->bottom == queue->capacity){
+        //the tasks are moved to the beginning, the array grows if it is still full
+        if(queue->top > 0){
+            memmove(queue->tasks, queue->tasks + queue->top, sizeof(TASK)*(queue->bottom - queue->top));
+            queue->bottom -= queue->top;
+            queue->top = 0;
+        }
+        if(queue->bottom == queue->capacity){
+            queue->capacity = queue->capacity > 0 ? 2*queue->capacity : 64;
+            queue->tasks = (TASK*) realloc(queue->tasks, sizeof(TASK)*queue->capacity);
+            if(queue->tasks == NULL){
+                printf("Memory allocation error!");
+                exit(1);
+            }
+        }
+    }
+    queue->tasks[queue->bottom].run = run;
+    queue->tasks[queue->bottom].argument = argument;
+    queue->bottom++;
+    pthread_mutex_unlock(&queue->lock);
+    return;
+}
+
+/*
+@brief a function that runs one task: the newest task of the thread, or the oldest task of another thread if its own deque is empty
+
+@param pool task pool
+@param worker index of the thread
+
+@return 1 if a task was run, 0 if all deques were empty
+*/
+int runNextTask(TASK_POOL* pool, int worker){
+    TASK task;
+    TASK_QUEUE* queue = &pool->queues[worker];
+    int i, found = 0;
+
+    pthread_mutex_lock(&queue->lock);
+    if(queue->bottom > queue->top){
+        queue->bottom--;
+        task = queue->tasks[queue->bottom];
+        found = 1;
+    }
+    pthread_mutex_unlock(&queue->lock);
+
+    for(i = 1; i < pool->workerCount && found == 0; i++){
+        queue = &pool->queues[(worker + i) % pool->workerCount];
+        pthread_mutex_lock(&queue->lock);
+        if(queue->bottom > queue->top){
+            task = queue->tasks[queue->top];
+            queue->top++;
+            found = 1;
+        }
+        pthread_mutex_unlock(&queue->lock);
+    }
+
+    if(found == 0){
+        return 0;
+    }
+    task.run(task.argument, worker);
+    atomic_fetch_sub(&pool->pending,1);
+    return 1;
+}
+
+/*
+@brief a function that runs tasks until a counter reaches its target, so a thread that waits for its subtasks helps the others
+
+@param pool task pool
+@param worker index of the thread
+@param done counter of the finished subtasks
+@param target number of subtasks
+
+@return
+*/
+void waitForTasks(TASK_POOL* pool, int worker, atomic_int* done, int target){
+    while(atomic_load(done) < target){
+        if(runNextTask(pool, worker) == 0){
+            sched_yield();
+        }
+    }
+    return;
+}
+
+/*
+@brief a function that runs one step of a block of a parallel partition
+
+@param argument block of the partition
+@param worker index of the thread
+
+@return
+*/
+void runPartitionBlock(void* argument, int worker){
+    PARTITION_BLOCK* block = (PARTITION_BLOCK*) argument;
+    int j;
+    (void) worker;
+
+    if(block->step == 1){
+        block->smaller = 0;
+        block->equal = 0;
+        for(j = block->start; j < block->end; j++){
+            block->smaller += block->arr[j] < block->pivot;
+            block->equal += block->arr[j] == block->pivot;
+        }
+    }else if(block->step == 2){
+        for(j = block->start; j < block->end; j++){
+            if(block->arr[j] < block->pivot){
+                block->buffer[block->smallerOffset++] = block->arr[j];
+            }else if(block->arr[j] == block->pivot){
+                block->buffer[block->equalOffset++] = block->arr[j];
+            }else{
+                block->buffer[block->largerOffset++] = block->arr[j];
+            }
+        }
+    }else{
+        memcpy(block->arr + block->start, block->buffer + block->start, sizeof(int)*(block->end - block->start));
+    }
+    atomic_fetch_add(block->done,1);
+    return;
+}
+
+/*
+@brief a function that partitions the array in parallel. Every block counts its elements that are smaller than and equal to the pivot,
+       the prefix sums of the counts give the place of every block in the partitioned range, then the blocks write their elements to
+       the buffer and copy them back. The order is the same as partition's: smaller elements, the pivot, larger elements
+
+@param pool task pool
+@param worker index of the thread
+@param arr array to be partitioned
+@param buffer temporary array, the range of arr is used in it
+@param left lower index of arr
+@param right higher index of arr
+@param pivot pivot element
+
+@return index where the pivot is placed
+*/
+int partitionInParallel(TASK_POOL* pool, int worker, int arr[], int buffer[], int left, int right, int pivot){
+    PARTITION_BLOCK blocks[MAX_BLOCKS];
+    atomic_int done;
+    int size = right - left + 1;
+    int blockCount = size / BLOCK_SIZE;
+    int i, step, smaller = 0, equal = 0, smallerBefore = 0, equalBefore = 0, largerBefore = 0;
+
+    if(blockCount > 4*pool->workerCount){
+        blockCount = 4*pool->workerCount;
+    }
+    if(blockCount > MAX_BLOCKS){
+        blockCount = MAX_BLOCKS;
+    }
+    if(blockCount < 1){
+        blockCount = 1;
+    }
+    for(i = 0; i < blockCount; i++){
+        blocks[i].arr = arr;
+        blocks[i].buffer = buffer;
+        blocks[i].start = left + (int)((long long)size*i/blockCount);
+        blocks[i].end = left + (int)((long long)size*(i + 1)/blockCount);
+        blocks[i].pivot = pivot;
+        blocks[i].done = &done;
+    }
+
+    for(step = 1; step <= 3; step++){
+        if(step == 2){
+            //the smaller elements of a block follow the smaller elements of the blocks before it, the same for equal and larger ones
+            for(i = 0; i < blockCount; i++){
+                smaller += blocks[i].smaller;
+                equal += blocks[i].equal;
+            }
+            for(i = 0; i < blockCount; i++){
+                blocks[i].smallerOffset = left + smallerBefore;
+                blocks[i].equalOffset = left + smaller + equalBefore;
+                blocks[i].largerOffset = left + smaller + equal + largerBefore;
+                smallerBefore += blocks[i].smaller;
+                equalBefore += blocks[i].equal;
+                largerBefore += blocks[i].end - blocks[i].start - blocks[i].smaller - blocks[i].equal;
+            }
+        }
+        atomic_store(&done,0);
+        for(i = 0; i < blockCount; i++){
+            blocks[i].step = step;
+            submitTask(pool, worker, runPartitionBlock, &blocks[i]);
+        }
+        waitForTasks(pool, worker, &done, blockCount);
+    }
+    return left + smaller;// index of pivot
+}
+
+/*
+@brief a function that matches a range of locks and keys as a task. The two halves are matched by new tasks, ranges up to SERIAL_CUTOFF
+       are matched serially with matchPairs
+
+@param argument range to be matched, it is freed
+@param worker index of the thread
+
+@return
+*/
+void runMatchTask(void* argument, int worker){
+    MATCH_TASK* task = (MATCH_TASK*) argument;
+    MATCH_TASK* half;
+    int pivot, i;
+
+    if(task->right - task->left + 1 <= SERIAL_CUTOFF){
+        matchPairs(task->locks, task->keys, task->left, task->right);
+        free(task);
+        return;
+    }
+
+    //select the pivot from the end of the keys and sort the locks and then the keys according to it, like matchPairs
+    if(task->right - task->left + 1 > PARTITION_CUTOFF){
+        pivot = partitionInParallel(task->pool, worker, task->locks, task->buffer, task->left, task->right, task->keys[task->right]);
+        partitionInParallel(task->pool, worker, task->keys, task->buffer, task->left, task->right, task->locks[pivot]);
+    }else{
+        pivot = partition(task->locks, task->left, task->right, task->keys[task->right]);
+        partition(task->keys, task->left, task->right, task->locks[pivot]);
+    }
+
+    for(i = 0; i < 2; i++){
+        half = (MATCH_TASK*) malloc(sizeof(MATCH_TASK));
+        if(half == NULL){
+            printf("Memory allocation error!");
+            exit(1);
+        }
+        *half = *task;
+        if(i == 0){
+            half->right = pivot - 1;
+        }else{
+            half->left = pivot + 1;
+        }
+        submitTask(task->pool, worker, runMatchTask, half);
+    }
+    free(task);
+    return;
+}
+
+/*
+@brief a function that runs tasks in a thread of the pool until all tasks are finished
+
+@param argument WORKER of the thread
+
+@return NULL
+*/
+void* runWorker(void* argument){
+    WORKER* worker = (WORKER*) argument;
+    while(atomic_load(&worker->pool->pending) > 0){
+        if(runNextTask(worker->pool, worker->index) == 0){
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+/*
+@brief a function that matches the pairs of locks and keys with a work-stealing pool of threads. Small arrays and a single thread use matchPairs
+
+@param locks array of locks
+@param keys array of keys
+@param N size of the arrays
+@param threadCount number of threads
+
+@return
+*/
+void matchPairsInParallel(int locks[], int keys[], int N, int threadCount){
+    TASK_POOL pool;
+    pthread_t threads[MAX_WORKERS];
+    WORKER workers[MAX_WORKERS];
+    int started[MAX_WORKERS];
+    MATCH_TASK* root;
+    int* buffer;
+    int i;
+
+    if(threadCount > MAX_WORKERS){
+        threadCount = MAX_WORKERS;
+    }
+    if(threadCount <= 1 || N <= SERIAL_CUTOFF){
+        matchPairs(locks, keys, 0, N-1);
+        return;
+    }
+
+    root = (MATCH_TASK*) malloc(sizeof(MATCH_TASK));
+    buffer = (int*) malloc(sizeof(int)*N);
+    if(root == NULL || buffer == NULL){
+        printf("Memory allocation error!");
+        exit(1);
+    }
+    pool.workerCount = threadCount;
+    atomic_init(&pool.pending,0);
+    for(i = 0; i < threadCount; i++){
+        pool.queues[i].tasks = NULL;
+        pool.queues[i].top = 0;
+        pool.queues[i].bottom = 0;
+        pool.queues[i].capacity = 0;
+        pthread_mutex_init(&pool.queues[i].lock,NULL);
+    }
+    root->pool = &pool;
+    root->locks = locks;
+    root->keys = keys;
+    root->buffer = buffer;
+    root->left = 0;
+    root->right = N-1;
+    //the root task is submitted before the threads start, so they do not stop before there is work
+    submitTask(&pool, 0, runMatchTask, root);
+
+    //the calling thread is the first thread of the pool
+    for(i = 0; i < threadCount; i++){
+        workers[i].pool = &pool;
+        workers[i].index = i;
+    }
+    //a thread that can not be started is skipped, the first thread steals the tasks of every queue
+    for(i = 1; i < threadCount; i++){
+        started[i] = pthread_create(&threads[i],NULL,runWorker,&workers[i]) == 0;
+    }
+    runWorker(&workers[0]);
+    for(i = 1; i < threadCount; i++){
+        if(started[i]){
+            pthread_join(threads[i],NULL);
+        }
+    }
+
+    for(i = 0; i < threadCount; i++){
+        free(pool.queues[i].tasks);
+        pthread_mutex_destroy(&pool.queues[i].lock);
+    }
+    free(buffer);
+    return;
+}
+
 int main() { 
     srand(time(NULL));
 
-    int N,i,left,right,option;
+    int N,i,option;
 
     printf("Enter N number: ");
     scanf("%d", &N);//size of arrays
     
-    int locks[N],keys[N];
+    //the arrays are allocated on the heap, millions of elements do not fit on the stack
+    int* locks = (int*) malloc(sizeof(int)*(N > 0 ? N : 1));
+    int* keys = (int*) malloc(sizeof(int)*(N > 0 ? N : 1));
+    if(locks == NULL || keys == NULL){
+        printf("Memory allocation error!");
+        exit(1);
+    }
 
     printf("\n1- Enter the arrays yourself");
     printf("\n2- Generate random arrays");
@@ -142,18 +565,20 @@ int main() {
 
         default:
             printf("Invalid option!");
+            free(locks);
+            free(keys);
             return 0;
     }
 
-    // Sort the arrays using QuickSort algorithm.
-    left = 0;
-    right = N-1;
-    matchPairs(locks, keys, left, right); 
+    // Sort the arrays using QuickSort algorithm, one thread for every processor
+    matchPairsInParallel(locks, keys, N, (int)sysconf(_SC_NPROCESSORS_ONLN)); 
   
     //Printing sorted arrays
     printf("\nMatched locks and keys are : \n");
     printArray(locks,N); 
     printArray(keys,N); 
 
+    free(locks);
+    free(keys);
     return 0;
 } 